@@ -19,8 +19,55 @@ a. Import Necessary Libraries
 #include <string>
 #include <vector>
 #include <sstream>
+#include <fstream>
 #include <cstdint>
 #include <stdexcept>
+#include <bitset>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <map>
+#include <atomic>
+#include <span>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <string_view>
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <bit>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <condition_variable>
+#include <latch>
+#include <concepts>
+#include <type_traits>
+#include <utility>
+#include <coroutine>
+#include <chrono>
+#include <cmath>
+
+// POSIX file descriptors and memory mapping for the streaming and file modes
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <csignal>
+
+// x86 vector intrinsics for the batch kernels (other targets use the scalar path)
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ONEGOD_X86 1
+#else
+#define ONEGOD_X86 0
+#endif
 
 // Using the standard namespace for simplicity
 using namespace std;
@@ -45,304 +92,5899 @@ c. Define Reflectors
 const uint16_t REFLECTOR_000 = 0x0000; // 16-bit all zeros
 const uint16_t REFLECTOR_FFF = 0xFFFF; // 16-bit all ones
 
+The pipeline runs on 16-, 32-, 64- or 128-bit words. Reflectors and keys are written as 16-bit patterns and widened by repetition, so REFLECTOR_FFF stays all ones at every width and KEY_333 becomes 0x03330333 in a 32-bit word.
+
+using uint128_t = unsigned __int128;
+
+template <typename Word>
+concept PipelineWord = same_as<Word, uint16_t> || same_as<Word, uint32_t> || same_as<Word, uint64_t> || same_as<Word, uint128_t>;
+
+template <PipelineWord Word>
+constexpr int WORD_BITS = static_cast<int>(8 * sizeof(Word));
+
+// Repeat a 16-bit pattern across a word
+template <PipelineWord Word>
+constexpr Word widen_pattern(uint16_t pattern) {
+    Word word = 0;
+    for (int shift = 0; shift < WORD_BITS<Word>; shift += 16) {
+        word |= static_cast<Word>(static_cast<Word>(pattern) << shift);
+    }
+    return word;
+}
+
+// a * b modulo 2^WORD_BITS; 16-bit operands would otherwise be promoted to (signed) int
+template <PipelineWord Word>
+constexpr Word wrapping_multiply(Word a, Word b) {
+    using Wide = conditional_t<(sizeof(Word) < sizeof(unsigned)), unsigned, Word>;
+    return static_cast<Word>(static_cast<Wide>(a) * static_cast<Wide>(b));
+}
+
 d. Define Transformation Functions (Five Operations)
 
-// Rotate left by 'bits' positions
-uint16_t rotate_left(uint16_t word, int bits = 1) {
-    return ((word << bits) | (word >> (16 - bits))) & 0xFFFF;
+// Rotate left by 'bits' positions (taken modulo the word width)
+template <PipelineWord Word>
+Word rotate_left(Word word, int bits = 1) {
+    constexpr int mask = WORD_BITS<Word> - 1;
+    bits &= mask;
+    return static_cast<Word>((word << bits) | (word >> (-bits & mask)));
 }
 
-// Rotate right by 'bits' positions
-uint16_t rotate_right(uint16_t word, int bits = 1) {
-    return ((word >> bits) | (word << (16 - bits))) & 0xFFFF;
+// Rotate right by 'bits' positions (taken modulo the word width)
+template <PipelineWord Word>
+Word rotate_right(Word word, int bits = 1) {
+    constexpr int mask = WORD_BITS<Word> - 1;
+    bits &= mask;
+    return static_cast<Word>((word >> bits) | (word << (-bits & mask)));
 }
 
 // XOR with a given key
-uint16_t xor_with_key(uint16_t word, uint16_t key) {
+template <PipelineWord Word>
+Word xor_with_key(Word word, type_identity_t<Word> key) {
     return word ^ key;
 }
 
-// Invert all bits
-uint16_t invert_bits(uint16_t word) {
-    return ~word & 0xFFFF;
-}
+// Invert all bits
+template <PipelineWord Word>
+Word invert_bits(Word word) {
+    return static_cast<Word>(~word);
+}
+
+// Reflect using a reflector
+template <PipelineWord Word>
+Word reflect(Word word, type_identity_t<Word> reflector) {
+    return word ^ reflector;
+}
+
+A sixth operation multiplies in GF(2^16): the word is read as a polynomial over GF(2) and multiplied by a nonzero constant modulo the primitive polynomial x^16 + x^12 + x^3 + x + 1. Multiplication by a fixed constant is still linear over GF(2), so it folds with the other operations, but where a rotation moves each bit and an XOR flips it, here every output bit depends on many input bits. On x86 with PCLMULQDQ a product is one carry-less multiply reduced by two more (Barrett reduction); elsewhere it is a lookup in log and antilog tables. Wider words multiply each 16-bit lane by the same constant.
+
+constexpr uint32_t GF16_POLYNOMIAL = 0x1100B;
+
+// Carry-less product of two 16-bit polynomials
+constexpr uint32_t carryless_multiply(uint32_t a, uint32_t b) {
+    uint32_t product = 0;
+    for (int bit = 0; bit < 16; ++bit) {
+        product ^= ((b >> bit) & 1) ? a << bit : 0;
+    }
+    return product;
+}
+
+// A product of two 16-bit polynomials modulo GF16_POLYNOMIAL, bit by bit
+constexpr uint16_t gf16_reduce(uint32_t product) {
+    for (int bit = 31; bit >= 16; --bit) {
+        product ^= ((product >> bit) & 1) ? GF16_POLYNOMIAL << (bit - 16) : 0;
+    }
+    return static_cast<uint16_t>(product);
+}
+
+// floor(x^32 / GF16_POLYNOMIAL), the Barrett constant
+constexpr uint32_t GF16_BARRETT = [] {
+    uint64_t remainder = uint64_t{ 1 } << 32;
+    uint32_t quotient = 0;
+    for (int bit = 16; bit >= 0; --bit) {
+        if ((remainder >> (bit + 16)) & 1) {
+            remainder ^= uint64_t{ GF16_POLYNOMIAL } << bit;
+            quotient |= 1u << bit;
+        }
+    }
+    return quotient;
+}();
+
+// exp[i] = x^i for i < 2 * 65535, and log[exp[i]] = i; log[0] is unused
+struct Gf16Tables {
+    array<uint16_t, 65536> log;
+    array<uint16_t, 2 * 65535> exp;
+};
+
+const Gf16Tables& gf16_tables() {
+    static const unique_ptr<Gf16Tables> tables = [] {
+        auto built = make_unique<Gf16Tables>();
+        uint16_t power = 1;
+        for (uint32_t i = 0; i < 65535; ++i) {
+            built->exp[i] = built->exp[i + 65535] = power;
+            built->log[power] = static_cast<uint16_t>(i);
+            power = gf16_reduce(carryless_multiply(power, 2));
+        }
+        built->log[0] = 0;
+        return built;
+    }();
+    return *tables;
+}
+
+uint16_t gf16_multiply_table(uint16_t a, uint16_t b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    const Gf16Tables& tables = gf16_tables();
+    return tables.exp[tables.log[a] + tables.log[b]];
+}
+
+#if ONEGOD_X86
+__attribute__((target("pclmul,sse2")))
+uint16_t gf16_multiply_pclmul(uint16_t a, uint16_t b) {
+    const __m128i product = _mm_clmulepi64_si128(_mm_cvtsi32_si128(a), _mm_cvtsi32_si128(b), 0x00);
+    const __m128i quotient = _mm_srli_epi64(
+        _mm_clmulepi64_si128(_mm_srli_epi64(product, 16), _mm_cvtsi32_si128(static_cast<int>(GF16_BARRETT)), 0x00), 16);
+    const __m128i reduced =
+        _mm_xor_si128(product, _mm_clmulepi64_si128(quotient, _mm_cvtsi32_si128(static_cast<int>(GF16_POLYNOMIAL)), 0x00));
+    return static_cast<uint16_t>(_mm_cvtsi128_si32(reduced));
+}
+#endif
+
+// PCLMULQDQ is used when the CPU has it, unless ONEGOD_SIMD=scalar
+bool gf16_use_pclmul() {
+    static const bool use = [] {
+#if ONEGOD_X86
+        __builtin_cpu_init();
+        const char* cap = getenv("ONEGOD_SIMD");
+        return __builtin_cpu_supports("pclmul") && !(cap && string_view(cap) == "scalar");
+#else
+        return false;
+#endif
+    }();
+    return use;
+}
+
+uint16_t gf16_multiply(uint16_t a, uint16_t b) {
+#if ONEGOD_X86
+    if (gf16_use_pclmul()) {
+        return gf16_multiply_pclmul(a, b);
+    }
+#endif
+    return gf16_multiply_table(a, b);
+}
+
+// a^-1 = a^(2^16 - 2); 0 has no inverse
+uint16_t gf16_inverse(uint16_t a) {
+    if (a == 0) {
+        throw invalid_argument("gf16_inverse: 0 has no multiplicative inverse");
+    }
+    const Gf16Tables& tables = gf16_tables();
+    return tables.exp[(65535 - tables.log[a]) % 65535];
+}
+
+// Multiply every 16-bit lane of the word by a constant in GF(2^16)
+template <PipelineWord Word>
+Word gf_multiply(Word word, uint16_t constant) {
+    Word product = 0;
+    for (int shift = 0; shift < WORD_BITS<Word>; shift += 16) {
+        product |= static_cast<Word>(static_cast<Word>(gf16_multiply(static_cast<uint16_t>(word >> shift), constant)) << shift);
+    }
+    return product;
+}
+
+e. Define the Trace Policy
+
+Narrating every operation of every word costs far more than the operations themselves. The transformation functions therefore take a trace level as a template parameter: Silent compiles to the bare arithmetic, Summary records one line per pipeline run, and Full records every step. Builds are Silent unless asked otherwise, so an ordinary run leaves no file behind. Records go to a per-thread buffer that is written to the trace file in large blocks, so tracing never interleaves with the snakes’ conversation on cout and cerr; if the file cannot be opened the records are dropped, never redirected to cerr.
+
+enum class TraceLevel {
+    Silent,
+    Summary,
+    Full
+};
+
+// Build-time default, e.g. g++ -DONEGOD_TRACE_LEVEL=Full
+#ifndef ONEGOD_TRACE_LEVEL
+#define ONEGOD_TRACE_LEVEL Silent
+#endif
+
+constexpr TraceLevel DEFAULT_TRACE_LEVEL = TraceLevel::ONEGOD_TRACE_LEVEL;
+
+// Trace destination: $ONEGOD_TRACE_FILE, or ONEGOD.trace in the working directory. Null when the file
+// cannot be opened; the records are then dropped rather than mixed into the conversation on cerr.
+FILE* trace_file() {
+    static FILE* file = [] {
+        const char* path = getenv("ONEGOD_TRACE_FILE");
+        path = path ? path : "ONEGOD.trace";
+        FILE* opened = fopen(path, "w");
+        if (!opened) {
+            cerr << "Warning: trace file " << path << " could not be opened; trace records are discarded" << endl;
+        }
+        return opened;
+    }();
+    return file;
+}
+
+// Buffered trace records, one compact text line each: "<stage>#<index> <before> <after>"
+// or "<stage>/<detail> <before> <after>"
+// with the words in hex, 4 digits per 16 bits. Each thread fills its own buffer and hands it to
+// the trace file in one write, so records from different threads never tear.
+class TraceSink {
+public:
+    explicit TraceSink(FILE* out) : out(out), used(0) {}
+    TraceSink(const TraceSink&) = delete;
+    TraceSink& operator=(const TraceSink&) = delete;
+    ~TraceSink() { flush(); }
+
+    template <typename Word>
+    void record(string_view stage, long index, Word before, Word after) {
+        if (used + stage.size() + 32 + sizeof(Word) * 4 > buffer.size()) {
+            flush();
+        }
+        used += stage.copy(buffer.data() + used, stage.size());
+        used += snprintf(buffer.data() + used, buffer.size() - used, "#%ld ", index);
+        append_hex(before);
+        buffer[used++] = ' ';
+        append_hex(after);
+        buffer[used++] = '\n';
+    }
+
+    // "<stage>/<detail> <before> <after>", e.g. an operation named by op_name
+    template <typename Word>
+    void record(string_view stage, string_view detail, Word before, Word after) {
+        if (used + stage.size() + detail.size() + 16 + sizeof(Word) * 4 > buffer.size()) {
+            flush();
+        }
+        used += stage.copy(buffer.data() + used, stage.size());
+        buffer[used++] = '/';
+        used += detail.copy(buffer.data() + used, detail.size());
+        buffer[used++] = ' ';
+        append_hex(before);
+        buffer[used++] = ' ';
+        append_hex(after);
+        buffer[used++] = '\n';
+    }
+
+    void flush() {
+        if (used > 0 && out) {
+            fwrite(buffer.data(), 1, used, out);
+            fflush(out);
+        }
+        used = 0;
+    }
+
+private:
+    template <typename Word>
+    void append_hex(Word word) {
+        static const char digits[] = "0123456789abcdef";
+        for (int shift = 8 * sizeof(Word) - 4; shift >= 0; shift -= 4) {
+            buffer[used++] = digits[static_cast<unsigned>(word >> shift) & 0xF];
+        }
+    }
+
+    FILE* out;
+    array<char, 1 << 16> buffer;
+    size_t used;
+};
+
+TraceSink& trace_sink() {
+    thread_local TraceSink sink(trace_file());
+    return sink;
+}
+
+Traces say what happened to each word; stage metrics say where the time goes, and they stay on. Each thread counts into a block of its own, one cache line per stage so no two threads ever write the same line, and registers the block once in a list that snapshots sum (see Metrics Snapshots). Counting a call is an add in the thread's own cache. Timing one takes two reads of the time-stamp counter, more than some stages cost, so every call is counted but only one in 64 per thread is timed, into a histogram of power-of-two tick buckets. The interpreted pipeline goes further and counts each run once rather than each of its stages, since every run passes through each stage once. Build with -DONEGOD_METRICS=0 to compile it all out.
+
+#ifndef ONEGOD_METRICS
+#define ONEGOD_METRICS 1
+#endif
+
+constexpr bool METRICS_ENABLED = ONEGOD_METRICS != 0;
+
+// Counter slots: the transformers by position (the last slot also takes any beyond it), then the other stages
+constexpr size_t METRIC_TRANSFORMERS = 8;
+constexpr size_t METRIC_CROWNED_PRIMES = METRIC_TRANSFORMERS;
+constexpr size_t METRIC_QUANTUM = METRIC_TRANSFORMERS + 1;
+constexpr size_t METRIC_HEX_CODEC = METRIC_TRANSFORMERS + 2;         // snakeA_response/snakeB_response parse and format
+constexpr size_t METRIC_BATCH_PIPELINE = METRIC_TRANSFORMERS + 3;    // snake_transformation_pipeline_batch, per call
+constexpr size_t METRIC_STAGES = METRIC_TRANSFORMERS + 4;
+constexpr int METRIC_BUCKETS = 32;                                    // Bucket b: timings below 2^b ticks
+constexpr uint64_t METRIC_SAMPLE_EVERY = 64;
+
+constexpr size_t metric_transformer(size_t position) {
+    return min(position, METRIC_TRANSFORMERS - 1);
+}
+
+// Time-stamp counter ticks where there is one, nanoseconds elsewhere
+inline uint64_t metric_ticks() {
+#if ONEGOD_X86
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+struct alignas(64) StageCounters {
+    atomic<uint64_t> calls{ 0 };
+    atomic<uint64_t> words{ 0 };
+    atomic<uint64_t> timed{ 0 };        // Calls sampled for timing
+    atomic<uint64_t> ticks{ 0 };        // Their total time
+    array<atomic<uint64_t>, METRIC_BUCKETS> histogram{};
+
+    // Only the owning thread writes, so a relaxed load and store (a plain add) cannot lose counts
+    static void add(atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+    }
+
+    // Count one call; true for the one call in METRIC_SAMPLE_EVERY to time
+    bool count(uint64_t call_words) {
+        const uint64_t called = calls.load(memory_order_relaxed) + 1;
+        calls.store(called, memory_order_relaxed);
+        add(words, call_words);
+        return called % METRIC_SAMPLE_EVERY == 0;
+    }
+
+    void time(uint64_t elapsed) {
+        add(timed, 1);
+        add(ticks, elapsed);
+        add(histogram[min(static_cast<int>(bit_width(elapsed)), METRIC_BUCKETS - 1)], 1);
+    }
+};
+
+struct ThreadMetrics {
+    array<StageCounters, METRIC_STAGES> stages;     // The interpreted pipeline's stages are only timed here
+    atomic<uint64_t> pipeline_runs{ 0 };            // ... and counted here
+
+    // Count a run of the interpreted pipeline; true for the one run in METRIC_SAMPLE_EVERY to time
+    bool pipeline_run() {
+        const uint64_t runs = pipeline_runs.load(memory_order_relaxed) + 1;
+        pipeline_runs.store(runs, memory_order_relaxed);
+        return runs % METRIC_SAMPLE_EVERY == 0;
+    }
+};
+
+// Every thread's counters, kept when the thread exits so totals never go backwards
+struct MetricsRegistry {
+    mutex registry_mutex;
+    vector<unique_ptr<ThreadMetrics>> threads;
+};
+
+MetricsRegistry& metrics_registry() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+ThreadMetrics* register_thread_metrics() {
+    MetricsRegistry& registry = metrics_registry();
+    lock_guard<mutex> lock(registry.registry_mutex);
+    registry.threads.push_back(make_unique<ThreadMetrics>());
+    return registry.threads.back().get();
+}
+
+ThreadMetrics& thread_metrics() {
+    // Constant-initialized, so reading it is one load with no guard
+    thread_local ThreadMetrics* metrics = nullptr;
+    if (metrics == nullptr) [[unlikely]] {
+        metrics = register_thread_metrics();
+    }
+    return *metrics;
+}
+
+// Times a stage from construction to the end of the scope, if 'timed'
+class StageTimer {
+public:
+    StageTimer(ThreadMetrics* metrics, size_t stage, bool timed)
+        : metrics(metrics), stage(stage), start(timed ? metric_ticks() : 0), timed(timed) {}
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+    ~StageTimer() {
+        if constexpr (METRICS_ENABLED) {
+            if (timed) {
+                metrics->stages[stage].time(metric_ticks() - start);
+            }
+        }
+    }
+
+private:
+    ThreadMetrics* metrics;
+    size_t stage;
+    uint64_t start;
+    bool timed;
+};
+
+// Times a stage that runs in pieces, each between start() and stop(), as one sample at the end of the scope
+class StageStopwatch {
+public:
+    StageStopwatch(ThreadMetrics* metrics, size_t stage, bool timed) : metrics(metrics), stage(stage), timed(timed) {}
+    StageStopwatch(const StageStopwatch&) = delete;
+    StageStopwatch& operator=(const StageStopwatch&) = delete;
+
+    ~StageStopwatch() {
+        if constexpr (METRICS_ENABLED) {
+            if (timed) {
+                metrics->stages[stage].time(ticks);
+            }
+        }
+    }
+
+    void start() {
+        if (timed) {
+            started = metric_ticks();
+        }
+    }
+
+    void stop() {
+        if (timed) {
+            ticks += metric_ticks() - started;
+        }
+    }
+
+private:
+    ThreadMetrics* metrics;
+    size_t stage;
+    uint64_t started = 0;
+    uint64_t ticks = 0;
+    bool timed;
+};
+
+// The calling thread's counters, or nullptr when metrics are compiled out
+inline ThreadMetrics* stage_metrics() {
+    if constexpr (METRICS_ENABLED) {
+        return &thread_metrics();
+    } else {
+        return nullptr;
+    }
+}
+
+f. Define Transformers (Three Transformers)
+
+Each transformer holds its operations as a small bytecode: an opcode naming one of the five operations plus its immediate value. The interpreter dispatches on the opcode, so operations keep their names in traces and can be inspected, fused and folded by the rest of the program.
+
+// Transformer bytecode opcodes
+enum class OpCode : uint8_t {
+    ROTL,     // rotate_left by imm bits
+    ROTR,     // rotate_right by imm bits
+    XOR,      // xor_with_key imm
+    NOT,      // invert_bits
+    REFLECT,  // reflect with reflector imm
+    CROWN,    // crowned prime: XOR with imm = prime * weight
+    GFMUL     // gf_multiply by the 16-bit constant imm (nonzero)
+};
+
+template <PipelineWord Word>
+struct BasicOp {
+    OpCode code;
+    Word imm;
+    uint32_t prime;   // CROWN only, kept for naming
+    Word weight;      // CROWN only, kept for naming
+
+    static BasicOp rotate_left(int bits) {
+        return {OpCode::ROTL, static_cast<Word>(bits & (WORD_BITS<Word> - 1)), 0, 0};
+    }
+    static BasicOp rotate_right(int bits) {
+        return {OpCode::ROTR, static_cast<Word>(bits & (WORD_BITS<Word> - 1)), 0, 0};
+    }
+    static BasicOp xor_with_key(Word key) { return {OpCode::XOR, key, 0, 0}; }
+    static BasicOp invert_bits() { return {OpCode::NOT, 0, 0, 0}; }
+    static BasicOp reflect(Word reflector) { return {OpCode::REFLECT, reflector, 0, 0}; }
+    static BasicOp crown(uint32_t prime, Word weight) {
+        return {OpCode::CROWN, wrapping_multiply<Word>(static_cast<Word>(prime), weight), prime, weight};
+    }
+    static BasicOp gf_multiply(uint16_t constant) {
+        if (constant == 0) {
+            throw invalid_argument("gfmul: multiplying by 0 cannot be undone; the constant must be nonzero");
+        }
+        return {OpCode::GFMUL, constant, 0, 0};
+    }
+};
+
+// The bytecode as written in transformers and spec files
+using Op = BasicOp<uint16_t>;
+
+// The same operation on a wider word: rotation amounts and GF(2^16) constants are
+// kept, while keys, reflectors and crown weights repeat their 16-bit pattern
+template <PipelineWord Word>
+BasicOp<Word> widen_op(const Op& op) {
+    switch (op.code) {
+        case OpCode::ROTL:    return BasicOp<Word>::rotate_left(op.imm);
+        case OpCode::ROTR:    return BasicOp<Word>::rotate_right(op.imm);
+        case OpCode::XOR:     return BasicOp<Word>::xor_with_key(widen_pattern<Word>(op.imm));
+        case OpCode::NOT:     return BasicOp<Word>::invert_bits();
+        case OpCode::REFLECT: return BasicOp<Word>::reflect(widen_pattern<Word>(op.imm));
+        case OpCode::CROWN:   return BasicOp<Word>::crown(op.prime, widen_pattern<Word>(op.weight));
+        case OpCode::GFMUL:   return BasicOp<Word>::gf_multiply(op.imm);
+    }
+    return BasicOp<Word>::invert_bits();
+}
+
+// Interpret one operation
+template <PipelineWord Word>
+inline Word execute(const BasicOp<Word>& op, Word word) {
+    switch (op.code) {
+        case OpCode::ROTL:    return rotate_left(word, static_cast<int>(op.imm));
+        case OpCode::ROTR:    return rotate_right(word, static_cast<int>(op.imm));
+        case OpCode::XOR:     return xor_with_key(word, op.imm);
+        case OpCode::NOT:     return invert_bits(word);
+        case OpCode::REFLECT: return reflect(word, op.imm);
+        case OpCode::CROWN:   return xor_with_key(word, op.imm);
+        case OpCode::GFMUL:   return gf_multiply(word, static_cast<uint16_t>(op.imm));
+    }
+    return word;
+}
+
+// "0x" and 4 hex digits per 16 bits of the word
+template <PipelineWord Word>
+string hex_literal(Word value) {
+    static const char digits[] = "0123456789abcdef";
+    string text = "0x";
+    for (int shift = WORD_BITS<Word> - 4; shift >= 0; shift -= 4) {
+        text += digits[static_cast<unsigned>(value >> shift) & 0xF];
+    }
+    return text;
+}
+
+// Spec-file spelling of an operation, e.g. "rotl 3" or "xor 0x0333"
+template <PipelineWord Word>
+string op_name(const BasicOp<Word>& op) {
+    switch (op.code) {
+        case OpCode::ROTL:    return "rotl " + to_string(static_cast<unsigned>(op.imm));
+        case OpCode::ROTR:    return "rotr " + to_string(static_cast<unsigned>(op.imm));
+        case OpCode::XOR:     return "xor " + hex_literal(op.imm);
+        case OpCode::NOT:     return "not";
+        case OpCode::REFLECT: return "reflect " + hex_literal(op.imm);
+        case OpCode::CROWN:   return "crown " + to_string(op.prime) + " " + hex_literal(op.weight);
+        case OpCode::GFMUL:   return "gfmul " + hex_literal(static_cast<uint16_t>(op.imm));
+    }
+    return "?";
+}
+
+// Fuse neighbouring operations: a run of XOR-like operations (XOR, NOT, REFLECT,
+// CROWN) becomes one XOR, a run of rotations becomes one left rotation, a run of
+// GF(2^16) multiplications becomes one, and anything that cancels out is dropped.
+template <PipelineWord Word>
+vector<BasicOp<Word>> fuse_ops(const vector<BasicOp<Word>>& ops) {
+    using WordOp = BasicOp<Word>;
+    constexpr int bits = WORD_BITS<Word>;
+    vector<WordOp> fused;
+    for (const WordOp& op : ops) {
+        WordOp next = op;
+        switch (op.code) {
+            case OpCode::ROTR:    next = WordOp::rotate_left(bits - static_cast<int>(op.imm)); break;
+            case OpCode::NOT:     next = WordOp::xor_with_key(static_cast<Word>(~Word{ 0 })); break;
+            case OpCode::REFLECT:
+            case OpCode::CROWN:   next = WordOp::xor_with_key(op.imm); break;
+            default: break;
+        }
+        if (!fused.empty() && fused.back().code == next.code) {
+            WordOp& last = fused.back();
+            if (next.code == OpCode::GFMUL) {
+                last.imm = gf16_multiply(static_cast<uint16_t>(last.imm), static_cast<uint16_t>(next.imm));
+            } else {
+                last.imm = next.code == OpCode::ROTL ? static_cast<Word>((last.imm + next.imm) & (bits - 1)) : last.imm ^ next.imm;
+            }
+        } else {
+            fused.push_back(next);
+        }
+        if (fused.back().imm == (fused.back().code == OpCode::GFMUL ? 1 : 0)) {
+            fused.pop_back();
+        }
+    }
+    return fused;
+}
+
+template <PipelineWord Word>
+class BasicTransformer {
+public:
+    string name;
+    vector<BasicOp<Word>> operations;   // As written; traced step by step
+    vector<BasicOp<Word>> fused;        // What runs when steps are not traced
+
+    BasicTransformer(string name, vector<BasicOp<Word>> ops) : name(name), operations(ops), fused(fuse_ops(ops)) {}
+
+    template <TraceLevel Trace = DEFAULT_TRACE_LEVEL>
+    Word apply(Word word) const {
+        if constexpr (Trace == TraceLevel::Full) {
+            for (const auto& op : operations) {
+                Word before = word;
+                word = execute(op, word);
+                trace_sink().record(name, op_name(op), before, word);
+            }
+        } else {
+            for (const auto& op : fused) {
+                word = execute(op, word);
+            }
+        }
+        return word;
+    }
+};
+
+using Transformer = BasicTransformer<uint16_t>;
+
+template <PipelineWord Word>
+BasicTransformer<Word> widen_transformer(const Transformer& transformer) {
+    vector<BasicOp<Word>> ops;
+    for (const Op& op : transformer.operations) {
+        ops.push_back(widen_op<Word>(op));
+    }
+    return BasicTransformer<Word>(transformer.name, ops);
+}
+
+// Undo one operation: rotations turn around, multiplications take the inverse
+// constant, and everything else is its own inverse
+template <PipelineWord Word>
+BasicOp<Word> inverse_op(const BasicOp<Word>& op) {
+    switch (op.code) {
+        case OpCode::ROTL:  return BasicOp<Word>::rotate_right(static_cast<int>(op.imm));
+        case OpCode::ROTR:  return BasicOp<Word>::rotate_left(static_cast<int>(op.imm));
+        case OpCode::GFMUL: return BasicOp<Word>::gf_multiply(gf16_inverse(static_cast<uint16_t>(op.imm)));
+        default:            return op;
+    }
+}
+
+// The transformer that undoes 'transformer': its operations inverted, in reverse order
+template <PipelineWord Word>
+BasicTransformer<Word> inverse_transformer(const BasicTransformer<Word>& transformer) {
+    vector<BasicOp<Word>> ops;
+    for (auto op = transformer.operations.rbegin(); op != transformer.operations.rend(); ++op) {
+        ops.push_back(inverse_op(*op));
+    }
+    return BasicTransformer<Word>(transformer.name + "^-1", ops);
+}
+
+g. Define Keys
+
+const uint16_t KEY_333 = 0x0333; // Hexadecimal representation of 333
+const uint16_t KEY_555 = 0x0555; // Hexadecimal representation of 555
+const uint16_t KEY_AAA = 0x0AAA; // Hexadecimal representation of AAA
+
+h. Initialize Transformers with Operations
+
+// Define operation sequences for each transformer
+Transformer transformer1("Transformer1", {
+    Op::rotate_left(3),
+    Op::xor_with_key(KEY_333)
+});
+
+Transformer transformer2("Transformer2", {
+    Op::invert_bits(),
+    Op::rotate_right(2)
+});
+
+Transformer transformer3("Transformer3", {
+    Op::reflect(REFLECTOR_FFF),
+    Op::xor_with_key(KEY_555),
+    Op::rotate_left(1)
+});
+
+// Collect all transformers
+const vector<Transformer> TRANSFORMERS = { transformer1, transformer2, transformer3 };
+
+i. Define Crowns of Weights (Crowned Primes)
+
+template <PipelineWord Word>
+struct BasicCrownedPrime {
+    uint32_t prime;     // Up to 32 bits, for the emirps of the sieve in Engine Extensions
+    Word weight;
+
+    BasicCrownedPrime(uint32_t p, Word w) : prime(p), weight(w) {}
+};
+
+using CrownedPrime = BasicCrownedPrime<uint16_t>;
+
+// The weight repeats its 16-bit pattern; the product is taken at the wider width
+template <PipelineWord Word>
+BasicCrownedPrime<Word> widen_crowned_prime(const CrownedPrime& cp) {
+    return BasicCrownedPrime<Word>(cp.prime, widen_pattern<Word>(cp.weight));
+}
+
+// Apply crowns of weights
+template <TraceLevel Trace = DEFAULT_TRACE_LEVEL, PipelineWord Word>
+Word apply_crowned_primes(Word word, const vector<BasicCrownedPrime<Word>>& crowned_primes) {
+    for (const auto& cp : crowned_primes) {
+        Word before = word;
+        Word transformation = wrapping_multiply<Word>(static_cast<Word>(cp.prime), cp.weight);
+        word = xor_with_key(word, transformation);
+        if constexpr (Trace == TraceLevel::Full) {
+            trace_sink().record("CrownedPrime", op_name(BasicOp<Word>::crown(cp.prime, cp.weight)), before, word);
+        }
+    }
+    return word;
+}
+
+j. Initialize Crowned Primes
+
+const vector<CrownedPrime> CROWNED_PRIMES = {
+    CrownedPrime(3, KEY_333), // 3 * 0x0333
+    CrownedPrime(5, KEY_555), // 5 * 0x0555
+    CrownedPrime(7, KEY_AAA)  // 7 * 0x0AAA
+};
+
+k. Define Quantum-Inspired Operators
+
+To enhance transformation complexity and introduce quantum-like unpredictability, we’ll simulate a simple quantum-inspired transformation.
+
+Measurements draw their randomness from a counter-based generator rather than a shared random state: each draw is a pure function of a seed, a stream id and the index of the word being measured. Any word can therefore be measured on any thread, in any order, and a given seed always reproduces the same output.
+
+const uint64_t DEFAULT_QUANTUM_SEED = 0x0AE0D5EED5A4E5ULL;
+
+// Identifies one reproducible sequence of measurements
+struct QuantumKey {
+    uint64_t seed;
+    uint64_t stream;
+};
+
+// QUANTUM measures every word, as the game always has, and loses the input in doing so.
+// CIPHER XORs the word with the bits an equal-superposition measurement would give
+// instead, which keeps the whole pipeline invertible.
+enum class PipelineMode { QUANTUM, CIPHER };
+
+// SplitMix64 finalizer
+inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// The part of every draw that depends only on the key; batch loops compute it once
+inline uint64_t quantum_stream_base(const QuantumKey& key) {
+    return splitmix64(key.seed ^ splitmix64(key.stream));
+}
+
+// 64 random bits for counter 'index' of the key's stream
+inline uint64_t quantum_draw(const QuantumKey& key, uint64_t index) {
+    return splitmix64(quantum_stream_base(key) ^ index);
+}
+
+// Uniform bits for word 'index' of a stream of 'Word's, cut from a stream base.
+// A draw serves 64 / WORD_BITS consecutive words; a 128-bit word takes two draws.
+template <PipelineWord Word>
+inline Word quantum_word_from_base(uint64_t base, uint64_t index) {
+    if constexpr (WORD_BITS<Word> <= 64) {
+        constexpr int per_draw = 64 / WORD_BITS<Word>;
+        return static_cast<Word>(splitmix64(base ^ (index / per_draw)) >> (WORD_BITS<Word> * (index % per_draw)));
+    } else {
+        return static_cast<Word>(splitmix64(base ^ (2 * index + 1))) << 64 | splitmix64(base ^ (2 * index));
+    }
+}
+
+template <PipelineWord Word>
+inline Word quantum_word(const QuantumKey& key, uint64_t index) {
+    return quantum_word_from_base<Word>(quantum_stream_base(key), index);
+}
+
+// 16 uniform bits for word 'index': each draw serves four consecutive words
+inline uint16_t quantum_bits(const QuantumKey& key, uint64_t index) {
+    return quantum_word<uint16_t>(key, index);
+}
+
+struct QuantumBit {
+    float state; // Probability of being 1
+
+    QuantumBit(float s = 0.5f) : state(s) {}
+
+    // Simulate Hadamard-like transformation (superposition)
+    void apply_hadamard() {
+        state = 0.5f;
+    }
+
+    // Probability of measuring 1 in steps of 1/65536 (65536 means certain)
+    uint32_t threshold() const {
+        float clamped = min(max(state, 0.0f), 1.0f);
+        return static_cast<uint32_t>(clamped * 65536.0f + 0.5f);
+    }
+
+    // Simulate measurement against a uniform 16-bit draw
+    int measure(uint16_t uniform) const {
+        return (uniform < threshold()) ? 1 : 0;
+    }
+};
+
+// Sixteen qubits prepared for measuring a whole word at once
+struct QuantumRegister {
+    array<uint16_t, 16> thresholds;   // Bit i measures 1 when its uniform draw is below thresholds[i]
+    uint16_t certain;                 // Bits with probability 1
+    bool equal_superposition;         // Every qubit at 0.5: one set of uniform bits is the measurement
+
+    static QuantumRegister from_qubits(const QuantumBit (&qubits)[16]) {
+        QuantumRegister reg;
+        reg.certain = 0;
+        reg.equal_superposition = true;
+        for (int i = 0; i < 16; ++i) {
+            uint32_t threshold = qubits[i].threshold();
+            reg.equal_superposition = reg.equal_superposition && threshold == 32768;
+            if (threshold >= 65536) {
+                reg.certain |= static_cast<uint16_t>(1u << i);
+                threshold = 0;
+            }
+            reg.thresholds[i] = static_cast<uint16_t>(threshold);
+        }
+        return reg;
+    }
+
+    uint16_t measure(const QuantumKey& key, uint64_t index) const {
+        if (equal_superposition) {
+            return quantum_bits(key, index);
+        }
+        // One uniform per qubit from four draws of a separate stream
+        const QuantumKey per_bit = { key.seed, key.stream ^ 0xD1B54A32D192ED03ULL };
+        alignas(16) uint16_t uniforms[16];
+        for (int k = 0; k < 4; ++k) {
+            uint64_t draw = quantum_draw(per_bit, index * 4 + k);
+            memcpy(uniforms + 4 * k, &draw, sizeof(draw));
+        }
+        return certain | below_thresholds(uniforms);
+    }
+
+private:
+    // Bit i set when uniforms[i] < thresholds[i], compared eight lanes at a time
+    uint16_t below_thresholds(const uint16_t* uniforms) const {
+#if ONEGOD_X86
+        // SSE2 only compares signed lanes, so shift both sides by 0x8000
+        const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+        __m128i u0 = _mm_xor_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(uniforms)), bias);
+        __m128i u1 = _mm_xor_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(uniforms + 8)), bias);
+        __m128i t0 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(thresholds.data())), bias);
+        __m128i t1 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(thresholds.data() + 8)), bias);
+        __m128i below = _mm_packs_epi16(_mm_cmplt_epi16(u0, t0), _mm_cmplt_epi16(u1, t1));
+        return static_cast<uint16_t>(_mm_movemask_epi8(below));
+#else
+        uint16_t mask = 0;
+        for (int i = 0; i < 16; ++i) {
+            mask |= static_cast<uint16_t>((uniforms[i] < thresholds[i]) << i);
+        }
+        return mask;
+#endif
+    }
+};
+
+// The qubits of any word after the Hadamard-like step
+const QuantumRegister& hadamard_register() {
+    static const QuantumRegister reg = [] {
+        QuantumBit qubits[16];
+        for (int i = 0; i < 16; ++i) {
+            qubits[i].apply_hadamard();
+        }
+        return QuantumRegister::from_qubits(qubits);
+    }();
+    return reg;
+}
+
+// Measure a word's qubits after the Hadamard-like step (no output).
+// The step puts every qubit in equal superposition whatever the word held,
+// so the prepared register is shared by all words.
+uint16_t quantum_measure(uint16_t word, const QuantumKey& key, uint64_t index) {
+    (void)word;
+    return hadamard_register().measure(key, index);
+}
+
+// XOR words[i] with the uniform bits of word first_index + i, taking each draw once for four words
+void quantum_keystream_xor_batch(uint16_t* words, size_t count, const QuantumKey& key, uint64_t first_index) {
+    const uint64_t base = quantum_stream_base(key);
+    size_t i = 0;
+    for (; i < count && ((first_index + i) & 3) != 0; ++i) {
+        words[i] ^= quantum_word_from_base<uint16_t>(base, first_index + i);
+    }
+    for (; i + 4 <= count; i += 4) {
+        const uint64_t draw = splitmix64(base ^ ((first_index + i) >> 2));
+        for (int lane = 0; lane < 4; ++lane) {
+            words[i + lane] ^= static_cast<uint16_t>(draw >> (16 * lane));
+        }
+    }
+    for (; i < count; ++i) {
+        words[i] ^= quantum_word_from_base<uint16_t>(base, first_index + i);
+    }
+}
+
+// Measure words[i] as word number first_index + i
+void quantum_measure_batch(uint16_t* words, size_t count, const QuantumKey& key, uint64_t first_index) {
+    const QuantumRegister& reg = hadamard_register();
+    if (reg.equal_superposition) {
+        fill(words, words + count, uint16_t{ 0 });
+        quantum_keystream_xor_batch(words, count, key, first_index);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        words[i] = reg.measure(key, first_index + i);
+    }
+}
+
+// Measure a wider word: every 16-bit lane is in equal superposition, so the
+// measurement is a word of uniform bits
+template <PipelineWord Word>
+Word quantum_measure(Word word, const QuantumKey& key, uint64_t index) {
+    (void)word;
+    return quantum_word<Word>(key, index);
+}
+
+// Quantum-inspired transformation; in cipher mode the keystream XOR, which is its own inverse
+template <TraceLevel Trace = DEFAULT_TRACE_LEVEL, PipelineWord Word>
+Word quantum_inspired_transform(Word word, const QuantumKey& key, uint64_t index,
+                                PipelineMode mode = PipelineMode::QUANTUM) {
+    Word transformed_word = mode == PipelineMode::CIPHER ? static_cast<Word>(word ^ quantum_word<Word>(key, index))
+                                                         : quantum_measure(word, key, index);
+    if constexpr (Trace == TraceLevel::Full) {
+        trace_sink().record(mode == PipelineMode::CIPHER ? "Keystream" : "Quantum", static_cast<long>(index),
+                            word, transformed_word);
+    }
+    return transformed_word;
+}
+
+l. Define the Snake Transformation Pipeline
+
+// Everything the pipeline is built from
+template <PipelineWord Word>
+struct BasicPipelineConfig {
+    vector<BasicTransformer<Word>> transformers;
+    vector<BasicCrownedPrime<Word>> crowned_primes;
+    Word final_reflector;
+    uint64_t seed;               // Quantum measurement seed
+    PipelineMode mode;
+};
+
+// Configurations are written, parsed and compiled at 16 bits and widened on demand
+using PipelineConfig = BasicPipelineConfig<uint16_t>;
+
+template <PipelineWord Word>
+BasicPipelineConfig<Word> widen_pipeline(const PipelineConfig& config) {
+    BasicPipelineConfig<Word> wide{ {}, {}, widen_pattern<Word>(config.final_reflector), config.seed, config.mode };
+    for (const auto& transformer : config.transformers) {
+        wide.transformers.push_back(widen_transformer<Word>(transformer));
+    }
+    for (const auto& cp : config.crowned_primes) {
+        wide.crowned_primes.push_back(widen_crowned_prime<Word>(cp));
+    }
+    return wide;
+}
+
+const PipelineConfig DEFAULT_PIPELINE = { TRANSFORMERS, CROWNED_PRIMES, REFLECTOR_FFF, DEFAULT_QUANTUM_SEED,
+                                          PipelineMode::QUANTUM };
+
+// The configuration the snakes use; main may replace it from a spec file before any word is transformed
+PipelineConfig& active_pipeline() {
+    static PipelineConfig config = DEFAULT_PIPELINE;
+    return config;
+}
+
+// The active configuration at another width, widened on first use
+template <PipelineWord Word>
+const BasicPipelineConfig<Word>& active_pipeline_as() {
+    if constexpr (same_as<Word, uint16_t>) {
+        return active_pipeline();
+    } else {
+        static const BasicPipelineConfig<Word> widened = widen_pipeline<Word>(active_pipeline());
+        return widened;
+    }
+}
+
+// The stages of snake_transformation_pipeline, each timed into the stage metrics if 'Timed'
+template <TraceLevel Trace, bool Timed, PipelineWord Word>
+Word snake_pipeline_stages(Word word, uint64_t index, uint64_t stream) {
+    const BasicPipelineConfig<Word>& config = active_pipeline_as<Word>();
+    Word initial_word = word;
+    ThreadMetrics* metrics = Timed ? stage_metrics() : nullptr;
+    constexpr bool timed = Timed;
+
+    // Apply all transformers
+    for (size_t i = 0; i < config.transformers.size(); ++i) {
+        StageTimer timer(metrics, metric_transformer(i), timed);
+        word = config.transformers[i].template apply<Trace>(word);
+    }
+
+    // Apply Crowns of Weights
+    {
+        StageTimer timer(metrics, METRIC_CROWNED_PRIMES, timed);
+        word = apply_crowned_primes<Trace>(word, config.crowned_primes);
+    }
+
+    // Apply Quantum-Inspired Transformation (the keystream in cipher mode)
+    {
+        StageTimer timer(metrics, METRIC_QUANTUM, timed);
+        word = quantum_inspired_transform<Trace>(word, QuantumKey{ config.seed, stream }, index, config.mode);
+    }
+
+    // Final Reflection with REFLECTOR_FFF (actual reflection)
+    Word word_before = word;
+    word = reflect(word, config.final_reflector);
+    if constexpr (Trace == TraceLevel::Full) {
+        trace_sink().record("FinalReflection", static_cast<long>(index), word_before, word);
+    }
+
+    // One record per word: initial -> final
+    if constexpr (Trace != TraceLevel::Silent) {
+        trace_sink().record("Pipeline", static_cast<long>(index), initial_word, word);
+    }
+    return word;
+}
+
+// 'index' is the word's position in its stream; together with the stream id and
+// the configured seed it fixes the quantum measurement
+template <TraceLevel Trace = DEFAULT_TRACE_LEVEL, PipelineWord Word>
+Word snake_transformation_pipeline(Word word, uint64_t index = 0, uint64_t stream = 0) {
+    // A separate copy for the sampled runs keeps the timers out of the others entirely
+    if (METRICS_ENABLED && stage_metrics()->pipeline_run()) [[unlikely]] {
+        return snake_pipeline_stages<Trace, true>(word, index, stream);
+    }
+    return snake_pipeline_stages<Trace, false>(word, index, stream);
+}
+
+// Undo snake_transformation_pipeline for a cipher-mode configuration by running every
+// stage's inverse in reverse order. Throws logic_error in quantum mode, whose
+// measurement does not depend on the word it measures.
+template <TraceLevel Trace = DEFAULT_TRACE_LEVEL, PipelineWord Word>
+Word snake_inverse_pipeline(Word word, uint64_t index = 0, uint64_t stream = 0) {
+    const BasicPipelineConfig<Word>& config = active_pipeline_as<Word>();
+    if (config.mode != PipelineMode::CIPHER) {
+        throw logic_error("snake_inverse_pipeline: only a cipher-mode pipeline can be inverted");
+    }
+    Word initial_word = word;
+
+    // Final reflection, keystream and crowns of weights are XORs, each its own inverse
+    word = reflect(word, config.final_reflector);
+    word = quantum_inspired_transform<Trace>(word, QuantumKey{ config.seed, stream }, index, config.mode);
+    word = apply_crowned_primes<Trace>(word, config.crowned_primes);
+
+    // Transformers last to first, each operation undone last to first
+    for (auto transformer = config.transformers.rbegin(); transformer != config.transformers.rend(); ++transformer) {
+        for (auto op = transformer->operations.rbegin(); op != transformer->operations.rend(); ++op) {
+            Word before = word;
+            word = execute(inverse_op(*op), word);
+            if constexpr (Trace == TraceLevel::Full) {
+                trace_sink().record(transformer->name + "^-1", op_name(inverse_op(*op)), before, word);
+            }
+        }
+    }
+
+    if constexpr (Trace != TraceLevel::Silent) {
+        trace_sink().record("InversePipeline", static_cast<long>(index), initial_word, word);
+    }
+    return word;
+}
+
+m. Visualization Function: Numbers as Bit Pattern Images
+
+void visualize_bit_pattern(uint16_t word, const string& title = "Bit Pattern") {
+    // Display the 16 bits as a 4x4 matrix, bit i at row i / 4, column i % 4
+    cout << "\n=== " << title << " ===\n";
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            cout << ((word >> (4 * row + column)) & 1 ? "█ " : "░ ");
+        }
+        cout << "\n";
+    }
+    cout << "=== End of " << title << " ===\n";
+}
+
+Note: To draw whole streams of words as tiles of one image, see Bit Pattern Images in the engine extensions.
+
+n. Define the Snake Communication Verification Function
+
+We’ll simulate both snakes within the same program by having Snake A send messages to Snake B, and vice versa. The verification ensures that the transformations are correctly applied and responses are as expected.
+
+// Hex digits in a message: 4 per 16 bits of the word
+template <PipelineWord Word>
+constexpr size_t HEX_DIGITS = sizeof(Word) * 2;
+
+// Parse a message of 1 to HEX_DIGITS hex digits. Anything else (empty, too long, a sign,
+// a 0x prefix, stray characters) is rejected rather than partially read.
+template <PipelineWord Word>
+bool parse_hex_word(string_view text, Word& word) {
+    if (text.empty() || text.size() > HEX_DIGITS<Word>) {
+        return false;
+    }
+    Word value = 0;
+    for (char c : text) {
+        int digit = c >= '0' && c <= '9' ? c - '0'
+                  : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                  : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+        if (digit < 0) {
+            return false;
+        }
+        value = static_cast<Word>(value << 4 | static_cast<Word>(digit));
+    }
+    word = value;
+    return true;
+}
+
+// Write a word as exactly HEX_DIGITS lowercase hex digits (no terminator)
+template <PipelineWord Word>
+inline void format_hex_word(Word word, char* out) {
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < HEX_DIGITS<Word>; ++i) {
+        out[i] = digits[static_cast<unsigned>(word >> (4 * (HEX_DIGITS<Word> - 1 - i))) & 0xF];
+    }
+}
+
+// Each snake measures its own stream of words, numbered by message
+const uint64_t SNAKE_A_STREAM = 0xA;
+const uint64_t SNAKE_B_STREAM = 0xB;
+
+// Simulate Snake B's behavior; the snakes talk in words of type Word
+template <PipelineWord Word = uint16_t>
+string snakeB_response(const string& message) {
+    static atomic<uint64_t> messages_answered{0};
+
+    // For simplicity, Snake B applies the same transformation pipeline
+    // to the received message's numerical representation.
+
+    ThreadMetrics* metrics = stage_metrics();
+    const bool timed = METRICS_ENABLED && metrics->stages[METRIC_HEX_CODEC].count(1);
+
+    // Parsing and formatting are timed together, one sample per message
+    StageStopwatch codec(metrics, METRIC_HEX_CODEC, timed);
+
+    // Convert hex string to integer
+    Word word;
+    codec.start();
+    if (!parse_hex_word(message, word)) {
+        throw invalid_argument("Snake B received a malformed message: '" + message + "'");
+    }
+    codec.stop();
+
+    // Apply transformation pipeline
+    Word transformed_word = snake_transformation_pipeline(word, messages_answered++, SNAKE_B_STREAM);
+
+    // Convert back to hex string
+    char response[HEX_DIGITS<Word>];
+    codec.start();
+    format_hex_word(transformed_word, response);
+    codec.stop();
+    return string(response, HEX_DIGITS<Word>);
+}
+
+// Simulate Snake A's behavior (optional, can mirror Snake B)
+template <PipelineWord Word = uint16_t>
+string snakeA_response(const string& message) {
+    static atomic<uint64_t> messages_answered{0};
+
+    // Similar to Snake B, or implement specific behavior
+    // Here, we assume Snake A also applies the transformation
+    ThreadMetrics* metrics = stage_metrics();
+    const bool timed = METRICS_ENABLED && metrics->stages[METRIC_HEX_CODEC].count(1);
+    StageStopwatch codec(metrics, METRIC_HEX_CODEC, timed);
+    Word word;
+    codec.start();
+    if (!parse_hex_word(message, word)) {
+        throw invalid_argument("Snake A received a malformed message: '" + message + "'");
+    }
+    codec.stop();
+
+    Word transformed_word = snake_transformation_pipeline(word, messages_answered++, SNAKE_A_STREAM);
+
+    char response[HEX_DIGITS<Word>];
+    codec.start();
+    format_hex_word(transformed_word, response);
+    codec.stop();
+    return string(response, HEX_DIGITS<Word>);
+}
+
+// Messages name the same word when they parse to the same value, so "5555dc7" matches "05555dc7"
+template <PipelineWord Word>
+bool same_word(const string& a, const string& b) {
+    Word x, y;
+    return parse_hex_word(a, x) && parse_hex_word(b, y) && x == y;
+}
+
+// Verification function. Every step runs even after a mismatch; the conversation goes
+// to cout and the mismatches are reported together on cerr at the end.
+// Returns true when both snakes answered every step as expected.
+template <PipelineWord Word = uint16_t>
+[[nodiscard]] bool verifySnakeCommunication(const vector<string>& outputs, const vector<string>& expectedA, const vector<string>& expectedB) {
+    struct StepMismatch {
+        size_t step;
+        char snake;
+        string expected;
+        string got;
+    };
+    vector<StepMismatch> mismatches;
+
+    for (size_t i = 0; i < outputs.size(); i++) {
+        cout << "\n--- Step " << i + 1 << " ---\n";
+        // Snake A sends output[i] to Snake B
+        string messageA = outputs[i];
+        cout << "Snake A sends to Snake B: " << messageA << endl;
+
+        // Snake B processes and responds
+        string responseB = snakeB_response<Word>(messageA);
+        cout << "Snake B responds with: " << responseB << endl;
+
+        // Verify B Snake's response
+        if (!same_word<Word>(responseB, expectedB[i])) {
+            mismatches.push_back({ i + 1, 'B', expectedB[i], responseB });
+        }
+
+        // Snake A expects expectedA[i] from B Snake
+        string messageExpectedA = expectedA[i];
+        cout << "Snake A expects to send: " << messageExpectedA << endl;
+
+        // Snake B processes and responds
+        string responseA = snakeA_response<Word>(messageExpectedA);
+        cout << "Snake A receives: " << responseA << endl;
+
+        // Verify A Snake's response
+        if (!same_word<Word>(responseA, outputs[i])) {
+            mismatches.push_back({ i + 1, 'A', outputs[i], responseA });
+        }
+    }
+
+    if (mismatches.empty()) {
+        cout << "\nAll steps verified successfully for both snakes!\n";
+        return true;
+    }
+    cerr << "Error: " << mismatches.size() << " of " << 2 * outputs.size() << " responses failed verification\n";
+    for (const auto& m : mismatches) {
+        cerr << "  step " << m.step << " snake " << m.snake << ": expected " << m.expected << ", got " << m.got << "\n";
+    }
+    return false;
+}
+
+3. Engine Extensions
+
+The components above describe the game one word at a time and narrate every step. The extensions below keep those components as the reference behaviour and add the machinery needed to push large volumes of words through the same pipeline.
+
+a. Pipeline Compiler: Folding the Deterministic Stages into One GF(2) Affine Map
+
+Every operation used by the transformers (rotations, XOR with a key, inversion, reflection, multiplication by a constant in GF(2^16)) and every crown of weights is affine over GF(2): it can be written as f(w) = M·w ⊕ c for a 16x16 bit-matrix M and a 16-bit constant c. Affine maps compose into affine maps, so the whole run of transformers and crowns in front of the quantum stage folds into a single matrix plus constant, and so does the final reflection behind it. For 16-bit words each folded map is then expanded once into a 65536-entry lookup table, turning the deterministic halves of the pipeline into one load each.
+
+// A 16x16 bit-matrix over GF(2) plus a constant: f(w) = M·w ⊕ c.
+// Column i holds the image of input bit i under the linear part.
+struct AffineMap16 {
+    array<uint16_t, 16> columns;
+    uint16_t constant;
+
+    static AffineMap16 identity() {
+        AffineMap16 map;
+        for (int i = 0; i < 16; ++i) {
+            map.columns[i] = static_cast<uint16_t>(1u << i);
+        }
+        map.constant = 0;
+        return map;
+    }
+
+    // M·w: XOR of the columns selected by the set bits of the word
+    uint16_t linear(uint16_t word) const {
+        uint16_t result = 0;
+        for (int i = 0; i < 16; ++i) {
+            result ^= columns[i] & static_cast<uint16_t>(-((word >> i) & 1));
+        }
+        return result;
+    }
+
+    uint16_t apply(uint16_t word) const {
+        return linear(word) ^ constant;
+    }
+
+    // Composition: apply this map first, then 'next'
+    AffineMap16 then(const AffineMap16& next) const {
+        AffineMap16 composed;
+        for (int i = 0; i < 16; ++i) {
+            composed.columns[i] = next.linear(columns[i]);
+        }
+        composed.constant = next.apply(constant);
+        return composed;
+    }
+
+    // f^-1(y) = M^-1·(y ⊕ c), with M inverted by Gauss-Jordan elimination.
+    // Throws invalid_argument when M is singular and the map cannot be undone.
+    AffineMap16 inverse() const {
+        // rows[r] holds bit r of every column; 'inverted' starts as the identity and
+        // receives the same row operations that reduce 'rows' to the identity
+        array<uint16_t, 16> rows{};
+        array<uint16_t, 16> inverted{};
+        for (int r = 0; r < 16; ++r) {
+            for (int i = 0; i < 16; ++i) {
+                rows[r] |= static_cast<uint16_t>(((columns[i] >> r) & 1) << i);
+            }
+            inverted[r] = static_cast<uint16_t>(1u << r);
+        }
+        for (int pivot = 0; pivot < 16; ++pivot) {
+            int r = pivot;
+            while (r < 16 && !((rows[r] >> pivot) & 1)) {
+                ++r;
+            }
+            if (r == 16) {
+                throw invalid_argument("AffineMap16::inverse: the linear part is singular");
+            }
+            swap(rows[r], rows[pivot]);
+            swap(inverted[r], inverted[pivot]);
+            for (int other = 0; other < 16; ++other) {
+                if (other != pivot && ((rows[other] >> pivot) & 1)) {
+                    rows[other] ^= rows[pivot];
+                    inverted[other] ^= inverted[pivot];
+                }
+            }
+        }
+
+        AffineMap16 result;
+        result.columns.fill(0);
+        for (int r = 0; r < 16; ++r) {
+            for (int i = 0; i < 16; ++i) {
+                result.columns[i] |= static_cast<uint16_t>(((inverted[r] >> i) & 1) << r);
+            }
+        }
+        result.constant = 0;
+        result.constant = result.linear(constant);
+        return result;
+    }
+
+    bool operator==(const AffineMap16& other) const {
+        return columns == other.columns && constant == other.constant;
+    }
+};
+
+// FNV-1a over the columns and the constant; identifies a folded pipeline configuration
+uint64_t affine_map_hash(const AffineMap16& map) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    auto mix = [&hash](uint16_t value) {
+        hash = (hash ^ (value & 0xFF)) * 0x100000001b3ULL;
+        hash = (hash ^ (value >> 8)) * 0x100000001b3ULL;
+    };
+    for (uint16_t column : map.columns) {
+        mix(column);
+    }
+    mix(map.constant);
+    return hash;
+}
+
+struct AffineMap16Hash {
+    size_t operator()(const AffineMap16& map) const {
+        return static_cast<size_t>(affine_map_hash(map));
+    }
+};
+
+// The affine map of a single bytecode operation
+AffineMap16 compile_op(const Op& op) {
+    AffineMap16 map = AffineMap16::identity();
+    switch (op.code) {
+        case OpCode::ROTL:
+        case OpCode::ROTR:
+        case OpCode::GFMUL:
+            for (int i = 0; i < 16; ++i) {
+                map.columns[i] = execute(op, static_cast<uint16_t>(1u << i));
+            }
+            break;
+        case OpCode::NOT:
+            map.constant = 0xFFFF;
+            break;
+        case OpCode::XOR:
+        case OpCode::REFLECT:
+        case OpCode::CROWN:
+            map.constant = op.imm;
+            break;
+    }
+    return map;
+}
+
+// Fold a transformer's operation list
+AffineMap16 compile_transformer(const Transformer& transformer) {
+    AffineMap16 map = AffineMap16::identity();
+    for (const auto& op : transformer.fused) {
+        map = map.then(compile_op(op));
+    }
+    return map;
+}
+
+// Fold the crowns of weights: one XOR with the combined products
+AffineMap16 compile_crowned_primes(const vector<CrownedPrime>& crowned_primes) {
+    AffineMap16 map = AffineMap16::identity();
+    for (const auto& cp : crowned_primes) {
+        map.constant ^= wrapping_multiply<uint16_t>(static_cast<uint16_t>(cp.prime), cp.weight);
+    }
+    return map;
+}
+
+// Lazily expand a folded map into a 65536-entry table. Tables are cached by
+// map, so every configuration that folds to the same function shares one.
+const vector<uint16_t>& affine_lookup_table(const AffineMap16& map) {
+    static mutex tables_mutex;
+    static unordered_map<AffineMap16, unique_ptr<vector<uint16_t>>, AffineMap16Hash> tables;
+
+    lock_guard<mutex> lock(tables_mutex);
+    auto& table = tables[map];
+    if (!table) {
+        table.reset(new vector<uint16_t>(65536));
+        vector<uint16_t>& entries = *table;
+        // f(w) = f(w without its lowest set bit) ⊕ column[lowest set bit]
+        entries[0] = map.constant;
+        for (uint32_t w = 1; w < 65536; ++w) {
+            int lowest = 0;
+            while (!((w >> lowest) & 1)) {
+                ++lowest;
+            }
+            entries[w] = entries[w & (w - 1)] ^ map.columns[lowest];
+        }
+    }
+    return *table;
+}
+
+b. Vector Kernels: Applying a Folded Map to Many Words at Once
+
+A folded map is applied to a whole span of words by one of four kernels, chosen once at runtime from what the CPU supports. When the linear part is a pure rotation, which is the case for any pipeline built only from rotations, XORs, inversions and reflections, the kernels run it as a vector shift, OR and XOR over 8, 16 or 32 words per register. Any other linear part is split into four nibble tables and evaluated with byte shuffles (AVX2, AVX-512) or bit-by-bit masks (SSE2). The scalar fallback reads the lookup table, so every kernel produces the same words.
+
+enum class SimdLevel {
+    SCALAR,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+SimdLevel detect_simd_level() {
+    SimdLevel level = SimdLevel::SCALAR;
+#if ONEGOD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw")) {
+        level = SimdLevel::AVX512;
+    } else if (__builtin_cpu_supports("avx2")) {
+        level = SimdLevel::AVX2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        level = SimdLevel::SSE2;
+    }
+#endif
+    // ONEGOD_SIMD=scalar|sse2|avx2 caps the level, e.g. to compare kernels
+    if (const char* cap = getenv("ONEGOD_SIMD")) {
+        string requested(cap);
+        SimdLevel limit = requested == "scalar" ? SimdLevel::SCALAR
+                        : requested == "sse2"   ? SimdLevel::SSE2
+                        : requested == "avx2"   ? SimdLevel::AVX2
+                                                : SimdLevel::AVX512;
+        level = min(level, limit);
+    }
+    return level;
+}
+
+SimdLevel simd_level() {
+    static const SimdLevel level = detect_simd_level();
+    return level;
+}
+
+// Rotation amount when M is a pure left rotation, -1 otherwise
+int affine_rotation(const AffineMap16& map) {
+    for (int bits = 0; bits < 16; ++bits) {
+        bool matches = true;
+        for (int i = 0; i < 16 && matches; ++i) {
+            matches = map.columns[i] == static_cast<uint16_t>(1u << ((i + bits) % 16));
+        }
+        if (matches) {
+            return bits;
+        }
+    }
+    return -1;
+}
+
+Bitslicing turns the layout around. A block of words is transposed into sixteen bit-planes, plane k holding bit k of every word in the block, and the folded map then works on whole planes: output plane j is the XOR of the input planes whose bit reaches output bit j, inverted when bit j of the constant is set. A rotation only renames planes, XORs with keys, inversion, reflection and the crowns only invert planes, and a GF(2^16) multiplication is a few plane XORs per output bit, so any map costs at most sixteen XORs per plane, spread over every word of the block. BitslicedKernel runs blocks of 512 words in AVX-512 registers, 256 in AVX2 registers and 64 in 64-bit integers elsewhere, with tails through the lookup table. The transposes take bit k of many bytes at once: into planes with a byte sign mask (a test against one bit per byte under AVX-512BW, a shift and movemask under AVX2), and back out with masked byte adds or byte compares. Every AffineKernel carries the bitsliced form of its map, and ONEGOD_KERNEL=bitsliced sends every span through it. That is not the default: the transposes cost more than the byte shuffles of the nibble tables, so on AVX-512 the bitsliced kernel takes about three times as long per word as AffineKernel, which --bench shows as the bitsliced variant of each stage.
+
+// A folded map over bit-planes: output plane j is the XOR of the input planes
+// sources[j][0 .. source_count[j]), inverted if bit j of the constant is set
+struct BitslicedKernel {
+    AffineMap16 map;
+    const uint16_t* table;   // tails
+    uint8_t sources[16][16];
+    uint8_t source_count[16];
+
+    static BitslicedKernel build(const AffineMap16& map) {
+        BitslicedKernel kernel;
+        kernel.map = map;
+        kernel.table = affine_lookup_table(map).data();
+        for (int j = 0; j < 16; ++j) {
+            kernel.source_count[j] = 0;
+            for (int i = 0; i < 16; ++i) {
+                if ((map.columns[i] >> j) & 1) {
+                    kernel.sources[j][kernel.source_count[j]++] = static_cast<uint8_t>(i);
+                }
+            }
+        }
+        return kernel;
+    }
+
+    void apply(const uint16_t* in, uint16_t* out, size_t count) const;
+};
+
+// Transpose an 8x8 bit matrix held one row per byte: bit c of byte r moves to bit r of byte c
+constexpr uint64_t transpose_bits_8x8(uint64_t x) {
+    uint64_t t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    return x ^ t ^ (t << 28);
+}
+
+// The low bytes of four 16-bit lanes, packed into 32 bits, and back (with zero high bytes)
+constexpr uint64_t pack_low_bytes(uint64_t lanes) {
+    lanes &= 0x00FF00FF00FF00FFULL;
+    lanes = (lanes | lanes >> 8) & 0x0000FFFF0000FFFFULL;
+    return (lanes | lanes >> 16) & 0xFFFFFFFFULL;
+}
+
+constexpr uint64_t spread_low_bytes(uint64_t bytes) {
+    bytes &= 0xFFFFFFFFULL;
+    bytes = (bytes | bytes << 16) & 0x0000FFFF0000FFFFULL;
+    return (bytes | bytes << 8) & 0x00FF00FF00FF00FFULL;
+}
+
+// Each kernel handles whole blocks and returns how many words it wrote.
+// 64 words as 8 groups of 8: the low bytes of a group are an 8x8 bit matrix whose
+// transpose holds bit k of the 8 words in byte k, and likewise the high bytes.
+size_t bitsliced_batch_portable(const BitslicedKernel& kernel, const uint16_t* in, uint16_t* out, size_t count) {
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        uint64_t planes[16] = {};
+        for (int g = 0; g < 8; ++g) {
+            uint64_t words[2];
+            memcpy(words, in + i + 8 * g, sizeof(words));
+            const uint64_t lo = transpose_bits_8x8(pack_low_bytes(words[0]) | pack_low_bytes(words[1]) << 32);
+            const uint64_t hi = transpose_bits_8x8(pack_low_bytes(words[0] >> 8) | pack_low_bytes(words[1] >> 8) << 32);
+            for (int k = 0; k < 8; ++k) {
+                planes[k] |= ((lo >> (8 * k)) & 0xFF) << (8 * g);
+                planes[k + 8] |= ((hi >> (8 * k)) & 0xFF) << (8 * g);
+            }
+        }
+        uint64_t mapped[16];
+        for (int j = 0; j < 16; ++j) {
+            uint64_t plane = ((kernel.map.constant >> j) & 1) ? ~uint64_t{ 0 } : 0;
+            for (int s = 0; s < kernel.source_count[j]; ++s) {
+                plane ^= planes[kernel.sources[j][s]];
+            }
+            mapped[j] = plane;
+        }
+        for (int g = 0; g < 8; ++g) {
+            uint64_t lo = 0, hi = 0;
+            for (int k = 0; k < 8; ++k) {
+                lo |= ((mapped[k] >> (8 * g)) & 0xFF) << (8 * k);
+                hi |= ((mapped[k + 8] >> (8 * g)) & 0xFF) << (8 * k);
+            }
+            lo = transpose_bits_8x8(lo);
+            hi = transpose_bits_8x8(hi);
+            const uint64_t words[2] = { spread_low_bytes(lo) | spread_low_bytes(hi) << 8,
+                                        spread_low_bytes(lo >> 32) | spread_low_bytes(hi >> 32) << 8 };
+            memcpy(out + i + 8 * g, words, sizeof(words));
+        }
+    }
+    return i;
+}
+
+#if ONEGOD_X86
+// 256 words as 8 groups of 32: the low bytes of a group packed in word order, then
+// bit k of all 32 by shifting it to the byte's top bit and taking the sign mask
+__attribute__((target("avx2")))
+size_t bitsliced_batch_avx2(const BitslicedKernel& kernel, const uint16_t* in, uint16_t* out, size_t count) {
+    const __m256i low_bytes = _mm256_set1_epi16(0x00FF);
+    // Byte b of a group's mask row sits in byte b / 8 of the mask, at bit b % 8
+    const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i bit_of_byte = _mm256_set1_epi64x(0x8040201008040201LL);
+    alignas(32) uint32_t fragments[16][8];   // fragments[k][g]: bit k of the words of group g
+    size_t i = 0;
+    for (; i + 256 <= count; i += 256) {
+        for (int g = 0; g < 8; ++g) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 32 * g));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 32 * g + 16));
+            const __m256i lo = _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_and_si256(a, low_bytes), _mm256_and_si256(b, low_bytes)), 0xD8);
+            const __m256i hi = _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8)), 0xD8);
+            for (int k = 0; k < 8; ++k) {
+                fragments[k][g] = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(lo, 7 - k)));
+                fragments[k + 8][g] = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(hi, 7 - k)));
+            }
+        }
+        __m256i planes[16];
+        for (int k = 0; k < 16; ++k) {
+            planes[k] = _mm256_load_si256(reinterpret_cast<const __m256i*>(fragments[k]));
+        }
+        for (int j = 0; j < 16; ++j) {
+            __m256i plane = ((kernel.map.constant >> j) & 1) ? _mm256_set1_epi32(-1) : _mm256_setzero_si256();
+            for (int s = 0; s < kernel.source_count[j]; ++s) {
+                plane = _mm256_xor_si256(plane, planes[kernel.sources[j][s]]);
+            }
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fragments[j]), plane);
+        }
+        for (int g = 0; g < 8; ++g) {
+            __m256i lo = _mm256_setzero_si256();
+            __m256i hi = _mm256_setzero_si256();
+            for (int k = 0; k < 8; ++k) {
+                const __m256i bit = _mm256_set1_epi8(static_cast<char>(1 << k));
+                __m256i set = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(fragments[k][g])), spread);
+                lo = _mm256_or_si256(lo, _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(set, bit_of_byte), bit_of_byte), bit));
+                set = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(fragments[k + 8][g])), spread);
+                hi = _mm256_or_si256(hi, _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(set, bit_of_byte), bit_of_byte), bit));
+            }
+            // Undo the packing order, then interleave the low and high bytes back into words
+            lo = _mm256_permute4x64_epi64(lo, 0xD8);
+            hi = _mm256_permute4x64_epi64(hi, 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 32 * g), _mm256_unpacklo_epi8(lo, hi));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 32 * g + 16), _mm256_unpackhi_epi8(lo, hi));
+        }
+    }
+    return i;
+}
+
+// 512 words as 8 groups of 64; AVX-512BW tests one bit of 64 bytes into a mask
+// register and adds a bit to the bytes a mask selects
+__attribute__((target("avx512f,avx512bw")))
+size_t bitsliced_batch_avx512(const BitslicedKernel& kernel, const uint16_t* in, uint16_t* out, size_t count) {
+    const __m512i low_bytes = _mm512_set1_epi16(0x00FF);
+    const __m512i pack_order = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m512i unpack_order = _mm512_setr_epi64(0, 4, 1, 5, 2, 6, 3, 7);
+    alignas(64) uint64_t fragments[16][8];   // fragments[k][g]: bit k of the words of group g
+    size_t i = 0;
+    for (; i + 512 <= count; i += 512) {
+        for (int g = 0; g < 8; ++g) {
+            const __m512i a = _mm512_loadu_si512(in + i + 64 * g);
+            const __m512i b = _mm512_loadu_si512(in + i + 64 * g + 32);
+            const __m512i lo = _mm512_permutexvar_epi64(pack_order, _mm512_packus_epi16(_mm512_and_si512(a, low_bytes), _mm512_and_si512(b, low_bytes)));
+            const __m512i hi = _mm512_permutexvar_epi64(pack_order, _mm512_packus_epi16(_mm512_srli_epi16(a, 8), _mm512_srli_epi16(b, 8)));
+            for (int k = 0; k < 8; ++k) {
+                const __m512i bit = _mm512_set1_epi8(static_cast<char>(1 << k));
+                fragments[k][g] = _mm512_test_epi8_mask(lo, bit);
+                fragments[k + 8][g] = _mm512_test_epi8_mask(hi, bit);
+            }
+        }
+        __m512i planes[16];
+        for (int k = 0; k < 16; ++k) {
+            planes[k] = _mm512_load_si512(fragments[k]);
+        }
+        for (int j = 0; j < 16; ++j) {
+            __m512i plane = ((kernel.map.constant >> j) & 1) ? _mm512_set1_epi32(-1) : _mm512_setzero_si512();
+            for (int s = 0; s < kernel.source_count[j]; ++s) {
+                plane = _mm512_xor_si512(plane, planes[kernel.sources[j][s]]);
+            }
+            _mm512_store_si512(fragments[j], plane);
+        }
+        for (int g = 0; g < 8; ++g) {
+            __m512i lo = _mm512_setzero_si512();
+            __m512i hi = _mm512_setzero_si512();
+            for (int k = 0; k < 8; ++k) {
+                const __m512i bit = _mm512_set1_epi8(static_cast<char>(1 << k));
+                lo = _mm512_mask_add_epi8(lo, fragments[k][g], lo, bit);
+                hi = _mm512_mask_add_epi8(hi, fragments[k + 8][g], hi, bit);
+            }
+            lo = _mm512_permutexvar_epi64(unpack_order, lo);
+            hi = _mm512_permutexvar_epi64(unpack_order, hi);
+            _mm512_storeu_si512(out + i + 64 * g, _mm512_unpacklo_epi8(lo, hi));
+            _mm512_storeu_si512(out + i + 64 * g + 32, _mm512_unpackhi_epi8(lo, hi));
+        }
+    }
+    return i;
+}
+#endif
+
+void BitslicedKernel::apply(const uint16_t* in, uint16_t* out, size_t count) const {
+    size_t done = 0;
+#if ONEGOD_X86
+    switch (simd_level()) {
+        case SimdLevel::AVX512: done = bitsliced_batch_avx512(*this, in, out, count); break;
+        case SimdLevel::AVX2:   done = bitsliced_batch_avx2(*this, in, out, count); break;
+        case SimdLevel::SSE2:
+        case SimdLevel::SCALAR: break;
+    }
+#endif
+    done += bitsliced_batch_portable(*this, in + done, out + done, count - done);
+    for (; done < count; ++done) {
+        out[done] = table[in[done]];
+    }
+}
+
+// A folded map prepared for every kernel
+struct AffineKernel {
+    AffineMap16 map;
+    const uint16_t* table;   // scalar path and tails
+    int rotation;            // see affine_rotation
+    BitslicedKernel bitsliced;
+    // Nibble k of the input selects byte tables: M·(v << 4k) split into low and high bytes
+    alignas(16) uint8_t nibble_lo[4][16];
+    alignas(16) uint8_t nibble_hi[4][16];
+
+    static AffineKernel build(const AffineMap16& map) {
+        AffineKernel kernel;
+        kernel.map = map;
+        kernel.table = affine_lookup_table(map).data();
+        kernel.rotation = affine_rotation(map);
+        kernel.bitsliced = BitslicedKernel::build(map);
+        for (int k = 0; k < 4; ++k) {
+            for (int v = 0; v < 16; ++v) {
+                uint16_t image = map.linear(static_cast<uint16_t>(v << (4 * k)));
+                kernel.nibble_lo[k][v] = static_cast<uint8_t>(image & 0xFF);
+                kernel.nibble_hi[k][v] = static_cast<uint8_t>(image >> 8);
+            }
+        }
+        return kernel;
+    }
+
+    void apply(const uint16_t* in, uint16_t* out, size_t count) const;
+};
+
+#if ONEGOD_X86
+// Each kernel handles whole registers and returns how many words it wrote
+
+__attribute__((target("sse2")))
+size_t affine_batch_sse2(const AffineKernel& kernel, const uint16_t* in, uint16_t* out, size_t count) {
+    const __m128i constant = _mm_set1_epi16(static_cast<short>(kernel.map.constant));
+    size_t i = 0;
+    if (kernel.rotation >= 0) {
+        const __m128i left = _mm_cvtsi32_si128(kernel.rotation);
+        const __m128i right = _mm_cvtsi32_si128(16 - kernel.rotation);
+        for (; i + 8 <= count; i += 8) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            x = _mm_or_si128(_mm_sll_epi16(x, left), _mm_srl_epi16(x, right));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(x, constant));
+        }
+        return i;
+    }
+
+    __m128i columns[16];
+    for (int bit = 0; bit < 16; ++bit) {
+        columns[bit] = _mm_set1_epi16(static_cast<short>(kernel.map.columns[bit]));
+    }
+    for (; i + 8 <= count; i += 8) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i acc = constant;
+        for (int bit = 0; bit < 16; ++bit) {
+            // All ones in the lanes whose word has this bit set
+            __m128i select = _mm_srai_epi16(_mm_sll_epi16(x, _mm_cvtsi32_si128(15 - bit)), 15);
+            acc = _mm_xor_si128(acc, _mm_and_si128(select, columns[bit]));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), acc);
+    }
+    return i;
+}
+
+// Look up two nibbles per 16-bit lane: 'a' tables for the nibble in the low byte,
+// 'b' tables for the nibble in the high byte, assembled into one 16-bit image
+__attribute__((target("avx2")))
+static inline __m256i nibble_pair_avx2(__m256i index, __m256i a_lo, __m256i a_hi, __m256i b_lo, __m256i b_hi) {
+    const __m256i low_bytes = _mm256_set1_epi16(0x00FF);
+    __m256i result = _mm256_and_si256(_mm256_shuffle_epi8(a_lo, index), low_bytes);
+    result = _mm256_xor_si256(result, _mm256_andnot_si256(low_bytes, _mm256_shuffle_epi8(b_hi, index)));
+    result = _mm256_xor_si256(result, _mm256_slli_epi16(_mm256_shuffle_epi8(a_hi, index), 8));
+    return _mm256_xor_si256(result, _mm256_srli_epi16(_mm256_shuffle_epi8(b_lo, index), 8));
+}
+
+__attribute__((target("avx2")))
+size_t affine_batch_avx2(const AffineKernel& kernel, const uint16_t* in, uint16_t* out, size_t count) {
+    const __m256i constant = _mm256_set1_epi16(static_cast<short>(kernel.map.constant));
+    size_t i = 0;
+    if (kernel.rotation >= 0) {
+        const __m128i left = _mm_cvtsi32_si128(kernel.rotation);
+        const __m128i right = _mm_cvtsi32_si128(16 - kernel.rotation);
+        for (; i + 16 <= count; i += 16) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            x = _mm256_or_si256(_mm256_sll_epi16(x, left), _mm256_srl_epi16(x, right));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_xor_si256(x, constant));
+        }
+        return i;
+    }
+
+    __m256i lo[4], hi[4];
+    for (int k = 0; k < 4; ++k) {
+        lo[k] = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(kernel.nibble_lo[k])));
+        hi[k] = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(kernel.nibble_hi[k])));
+    }
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+    for (; i + 16 <= count; i += 16) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i low_nibbles = _mm256_and_si256(x, nibble_mask);                         // nibbles 0 and 2
+        __m256i high_nibbles = _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble_mask);  // nibbles 1 and 3
+        __m256i acc = _mm256_xor_si256(constant, nibble_pair_avx2(low_nibbles, lo[0], hi[0], lo[2], hi[2]));
+        acc = _mm256_xor_si256(acc, nibble_pair_avx2(high_nibbles, lo[1], hi[1], lo[3], hi[3]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), acc);
+    }
+    return i;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static inline __m512i nibble_pair_avx512(__m512i index, __m512i a_lo, __m512i a_hi, __m512i b_lo, __m512i b_hi) {
+    const __m512i low_bytes = _mm512_set1_epi16(0x00FF);
+    __m512i result = _mm512_and_si512(_mm512_shuffle_epi8(a_lo, index), low_bytes);
+    result = _mm512_xor_si512(result, _mm512_andnot_si512(low_bytes, _mm512_shuffle_epi8(b_hi, index)));
+    result = _mm512_xor_si512(result, _mm512_slli_epi16(_mm512_shuffle_epi8(a_hi, index), 8));
+    return _mm512_xor_si512(result, _mm512_srli_epi16(_mm512_shuffle_epi8(b_lo, index), 8));
+}
+
+__attribute__((target("avx512f,avx512bw")))
+size_t affine_batch_avx512(const AffineKernel& kernel, const uint16_t* in, uint16_t* out, size_t count) {
+    const __m512i constant = _mm512_set1_epi16(static_cast<short>(kernel.map.constant));
+    size_t i = 0;
+    if (kernel.rotation >= 0) {
+        const __m128i left = _mm_cvtsi32_si128(kernel.rotation);
+        const __m128i right = _mm_cvtsi32_si128(16 - kernel.rotation);
+        for (; i + 32 <= count; i += 32) {
+            __m512i x = _mm512_loadu_si512(in + i);
+            x = _mm512_or_si512(_mm512_sll_epi16(x, left), _mm512_srl_epi16(x, right));
+            _mm512_storeu_si512(out + i, _mm512_xor_si512(x, constant));
+        }
+        return i;
+    }
+
+    __m512i lo[4], hi[4];
+    for (int k = 0; k < 4; ++k) {
+        lo[k] = _mm512_broadcast_i32x4(_mm_load_si128(reinterpret_cast<const __m128i*>(kernel.nibble_lo[k])));
+        hi[k] = _mm512_broadcast_i32x4(_mm_load_si128(reinterpret_cast<const __m128i*>(kernel.nibble_hi[k])));
+    }
+    const __m512i nibble_mask = _mm512_set1_epi8(0x0F);
+    for (; i + 32 <= count; i += 32) {
+        __m512i x = _mm512_loadu_si512(in + i);
+        __m512i low_nibbles = _mm512_and_si512(x, nibble_mask);
+        __m512i high_nibbles = _mm512_and_si512(_mm512_srli_epi16(x, 4), nibble_mask);
+        __m512i acc = _mm512_xor_si512(constant, nibble_pair_avx512(low_nibbles, lo[0], hi[0], lo[2], hi[2]));
+        acc = _mm512_xor_si512(acc, nibble_pair_avx512(high_nibbles, lo[1], hi[1], lo[3], hi[3]));
+        _mm512_storeu_si512(out + i, acc);
+    }
+    return i;
+}
+#endif
+
+// ONEGOD_KERNEL=bitsliced sends every folded map through BitslicedKernel
+bool bitsliced_backend() {
+    static const bool bitsliced = [] {
+        const char* kernel = getenv("ONEGOD_KERNEL");
+        return kernel && string_view(kernel) == "bitsliced";
+    }();
+    return bitsliced;
+}
+
+void AffineKernel::apply(const uint16_t* in, uint16_t* out, size_t count) const {
+    if (bitsliced_backend()) {
+        bitsliced.apply(in, out, count);
+        return;
+    }
+    size_t done = 0;
+#if ONEGOD_X86
+    switch (simd_level()) {
+        case SimdLevel::AVX512: done = affine_batch_avx512(*this, in, out, count); break;
+        case SimdLevel::AVX2:   done = affine_batch_avx2(*this, in, out, count); break;
+        case SimdLevel::SSE2:   done = affine_batch_sse2(*this, in, out, count); break;
+        case SimdLevel::SCALAR: break;
+    }
+#endif
+    for (; done < count; ++done) {
+        out[done] = table[in[done]];
+    }
+}
+
+c. The Compiled Pipeline and the Batch Entry Point
+
+// The pipeline with its deterministic halves folded into kernels and lookup tables
+struct CompiledPipeline {
+    AffineKernel pre_quantum;    // Transformers and Crowns of Weights
+    AffineKernel post_quantum;   // Final reflection
+    uint64_t config_hash;
+    uint64_t seed;
+    PipelineMode mode;
+
+    uint16_t run(uint16_t word, uint64_t index = 0, uint64_t stream = 0) const {
+        word = pre_quantum.table[word];
+        word = mode == PipelineMode::CIPHER ? static_cast<uint16_t>(word ^ quantum_bits(QuantumKey{ seed, stream }, index))
+                                            : quantum_measure(word, QuantumKey{ seed, stream }, index);
+        return post_quantum.table[word];
+    }
+};
+
+uint64_t compiled_pipeline_hash(const AffineMap16& pre, const AffineMap16& post, PipelineMode mode) {
+    uint64_t hash = affine_map_hash(pre) ^ (affine_map_hash(post) * 0x9E3779B97F4A7C15ULL);
+    return mode == PipelineMode::CIPHER ? splitmix64(hash) : hash;
+}
+
+CompiledPipeline compile_pipeline(const PipelineConfig& config) {
+    AffineMap16 pre = AffineMap16::identity();
+    for (const auto& transformer : config.transformers) {
+        pre = pre.then(compile_transformer(transformer));
+    }
+    pre = pre.then(compile_crowned_primes(config.crowned_primes));
+
+    AffineMap16 post = AffineMap16::identity();
+    post.constant = config.final_reflector;
+
+    CompiledPipeline compiled;
+    compiled.pre_quantum = AffineKernel::build(pre);
+    compiled.post_quantum = AffineKernel::build(post);
+    compiled.config_hash = compiled_pipeline_hash(pre, post, config.mode);
+    compiled.seed = config.seed;
+    compiled.mode = config.mode;
+    return compiled;
+}
+
+// The pipeline that undoes compile_pipeline(config): both folded maps inverted and
+// swapped around the keystream, which cancels itself. It runs through the same
+// kernels, so decrypting costs what encrypting does. Only cipher mode can be undone.
+CompiledPipeline compile_inverse_pipeline(const PipelineConfig& config) {
+    if (config.mode != PipelineMode::CIPHER) {
+        throw invalid_argument("only a cipher-mode pipeline can be inverted; the quantum stage discards its input");
+    }
+    const CompiledPipeline forward = compile_pipeline(config);
+    const AffineMap16 pre = forward.post_quantum.map.inverse();
+    const AffineMap16 post = forward.pre_quantum.map.inverse();
+
+    CompiledPipeline inverse = forward;
+    inverse.pre_quantum = AffineKernel::build(pre);
+    inverse.post_quantum = AffineKernel::build(post);
+    inverse.config_hash = compiled_pipeline_hash(pre, post, config.mode) ^ 0x1;
+    return inverse;
+}
+
+// Compiled once from active_pipeline() on first use
+const CompiledPipeline& active_compiled_pipeline() {
+    static const CompiledPipeline compiled = compile_pipeline(active_pipeline());
+    return compiled;
+}
+
+const CompiledPipeline& active_compiled_inverse() {
+    static const CompiledPipeline compiled = compile_inverse_pipeline(active_pipeline());
+    return compiled;
+}
+
+// Run the pipeline over a span of words; 'out' may alias 'in'. in[i] is measured
+// as word first_index + i of the stream, so splitting a stream into batches, in
+// any order or on any thread, gives the same words as CompiledPipeline::run.
+void snake_transformation_pipeline_batch(const CompiledPipeline& pipeline, span<const uint16_t> in, span<uint16_t> out,
+                                         uint64_t first_index = 0, uint64_t stream = 0) {
+    if (out.size() < in.size()) {
+        throw invalid_argument("snake_transformation_pipeline_batch: output span is shorter than input");
+    }
+    // A batch is long enough to time every call
+    ThreadMetrics* metrics = stage_metrics();
+    if constexpr (METRICS_ENABLED) {
+        metrics->stages[METRIC_BATCH_PIPELINE].count(in.size());
+    }
+    StageTimer timer(metrics, METRIC_BATCH_PIPELINE, METRICS_ENABLED);
+    // Measurement discards the word it measures, so only a cipher needs the front half run
+    if (pipeline.mode == PipelineMode::CIPHER) {
+        pipeline.pre_quantum.apply(in.data(), out.data(), in.size());
+        quantum_keystream_xor_batch(out.data(), in.size(), QuantumKey{ pipeline.seed, stream }, first_index);
+    } else {
+        quantum_measure_batch(out.data(), in.size(), QuantumKey{ pipeline.seed, stream }, first_index);
+    }
+    pipeline.post_quantum.apply(out.data(), out.data(), in.size());
+}
+
+void snake_transformation_pipeline_batch(span<const uint16_t> in, span<uint16_t> out,
+                                         uint64_t first_index = 0, uint64_t stream = 0) {
+    snake_transformation_pipeline_batch(active_compiled_pipeline(), in, out, first_index, stream);
+}
+
+Note: compile_op folds the bytecode directly rather than running Transformer::apply, so folding a pipeline records no trace. CompiledPipeline::run and snake_transformation_pipeline_batch produce the same words as snake_transformation_pipeline<TraceLevel::Silent>.
+
+d. Pipeline Spec Files
+
+A pipeline can also be described in a small text file and loaded at startup, so configurations change without recompiling. Each line holds one keyword and its arguments; numbers are decimal or 0x-prefixed hex, and # starts a comment. The default pipeline reads:
+
+# ONEGOD pipeline spec
+transformer Transformer1
+    rotl 3
+    xor 0x0333
+transformer Transformer2
+    not
+    rotr 2
+transformer Transformer3
+    reflect 0xFFFF
+    xor 0x0555
+    rotl 1
+crowned_prime 3 0x0333
+crowned_prime 5 0x0555
+crowned_prime 7 0x0AAA
+final_reflector 0xFFFF
+seed 0x0AE0D5EED5A4E5
+mode quantum
+
+Operation lines (rotl, rotr, xor, not, reflect, gfmul <constant>, and crown <prime> <weight>) belong to the most recent transformer line, using the same spelling as op_name. crowned_prime lines build the Crowns of Weights stage, and emirp_crowns <count> <limit> adds that many crowns drawn from the emirps up to the limit (see Emirp Sieve); seed fixes the quantum measurements, and mode cipher swaps the measurement for its invertible keystream.
+
+// A spec-file number that must fit in 16 bits
+uint16_t parse_spec_number(const string& token, const string& where) {
+    size_t used = 0;
+    unsigned long value = 0;
+    try {
+        value = stoul(token, &used, 0);
+    } catch (const exception&) {
+        used = 0;
+    }
+    if (used != token.size() || value > 0xFFFF) {
+        throw runtime_error(where + ": expected a 16-bit number, got '" + token + "'");
+    }
+    return static_cast<uint16_t>(value);
+}
+
+// A spec-file number that must fit in 32 bits: crown primes and emirp limits
+uint32_t parse_spec_number32(const string& token, const string& where) {
+    size_t used = 0;
+    unsigned long long value = 0;
+    try {
+        value = stoull(token, &used, 0);
+    } catch (const exception&) {
+        used = 0;
+    }
+    if (used != token.size() || token[0] == '-' || value > 0xFFFFFFFF) {
+        throw runtime_error(where + ": expected a 32-bit number, got '" + token + "'");
+    }
+    return static_cast<uint32_t>(value);
+}
+
+// Crowns of weights from the emirp sieve (see Emirp Sieve)
+vector<CrownedPrime> emirp_crowned_primes(size_t count, uint32_t limit);
+
+// A 64-bit quantum seed, decimal or 0x-prefixed hex
+uint64_t parse_seed(const string& token, const string& where) {
+    size_t used = 0;
+    uint64_t value = 0;
+    try {
+        value = stoull(token, &used, 0);
+    } catch (const exception&) {
+        used = 0;
+    }
+    if (used != token.size() || token[0] == '-') {
+        throw runtime_error(where + ": expected a 64-bit seed, got '" + token + "'");
+    }
+    return value;
+}
+
+PipelineConfig parse_pipeline_spec(istream& in, const string& source) {
+    vector<pair<string, vector<Op>>> transformers;
+    PipelineConfig config;
+    config.final_reflector = REFLECTOR_FFF;
+    config.seed = DEFAULT_QUANTUM_SEED;
+    config.mode = PipelineMode::QUANTUM;
+
+    string line;
+    int line_number = 0;
+    while (getline(in, line)) {
+        ++line_number;
+        const string where = source + ":" + to_string(line_number);
+        istringstream tokens(line.substr(0, line.find('#')));
+        vector<string> words;
+        for (string word; tokens >> word;) {
+            words.push_back(word);
+        }
+        if (words.empty()) {
+            continue;
+        }
+
+        const string& keyword = words[0];
+        auto expect_arguments = [&](size_t count) {
+            if (words.size() != count + 1) {
+                throw runtime_error(where + ": '" + keyword + "' takes " + to_string(count) + " argument(s)");
+            }
+        };
+        auto number = [&](size_t index) { return parse_spec_number(words[index], where); };
+        auto rotation = [&](size_t index) {
+            uint16_t bits = number(index);
+            if (bits > 15) {
+                throw runtime_error(where + ": rotation must be between 0 and 15");
+            }
+            return static_cast<int>(bits);
+        };
+
+        if (keyword == "transformer") {
+            expect_arguments(1);
+            transformers.emplace_back(words[1], vector<Op>());
+            continue;
+        }
+        if (keyword == "crowned_prime") {
+            expect_arguments(2);
+            config.crowned_primes.emplace_back(parse_spec_number32(words[1], where), number(2));
+            continue;
+        }
+        if (keyword == "emirp_crowns") {
+            expect_arguments(2);
+            try {
+                for (const CrownedPrime& cp : emirp_crowned_primes(parse_spec_number32(words[1], where),
+                                                                   parse_spec_number32(words[2], where))) {
+                    config.crowned_primes.push_back(cp);
+                }
+            } catch (const invalid_argument& e) {
+                throw runtime_error(where + ": " + e.what());
+            }
+            continue;
+        }
+        if (keyword == "final_reflector") {
+            expect_arguments(1);
+            config.final_reflector = number(1);
+            continue;
+        }
+        if (keyword == "seed") {
+            expect_arguments(1);
+            config.seed = parse_seed(words[1], where);
+            continue;
+        }
+        if (keyword == "mode") {
+            expect_arguments(1);
+            if (words[1] != "quantum" && words[1] != "cipher") {
+                throw runtime_error(where + ": mode must be 'quantum' or 'cipher'");
+            }
+            config.mode = words[1] == "cipher" ? PipelineMode::CIPHER : PipelineMode::QUANTUM;
+            continue;
+        }
+
+        Op op;
+        if (keyword == "rotl") {
+            expect_arguments(1);
+            op = Op::rotate_left(rotation(1));
+        } else if (keyword == "rotr") {
+            expect_arguments(1);
+            op = Op::rotate_right(rotation(1));
+        } else if (keyword == "xor") {
+            expect_arguments(1);
+            op = Op::xor_with_key(number(1));
+        } else if (keyword == "not") {
+            expect_arguments(0);
+            op = Op::invert_bits();
+        } else if (keyword == "reflect") {
+            expect_arguments(1);
+            op = Op::reflect(number(1));
+        } else if (keyword == "crown") {
+            expect_arguments(2);
+            op = Op::crown(parse_spec_number32(words[1], where), number(2));
+        } else if (keyword == "gfmul") {
+            expect_arguments(1);
+            if (number(1) == 0) {
+                throw runtime_error(where + ": gfmul needs a nonzero constant");
+            }
+            op = Op::gf_multiply(number(1));
+        } else {
+            throw runtime_error(where + ": unknown keyword '" + keyword + "'");
+        }
+        if (transformers.empty()) {
+            throw runtime_error(where + ": operation '" + keyword + "' appears before any transformer");
+        }
+        transformers.back().second.push_back(op);
+    }
+
+    for (const auto& [name, ops] : transformers) {
+        config.transformers.emplace_back(name, ops);
+    }
+    return config;
+}
+
+PipelineConfig load_pipeline_spec(const string& path) {
+    ifstream in(path);
+    if (!in) {
+        throw runtime_error("cannot open pipeline spec: " + path);
+    }
+    return parse_pipeline_spec(in, path);
+}
+
+e. Hex Codec and Batch Responses
+
+Messages between the snakes are fixed-width hex tokens, so decoding and encoding them many at a time maps well onto byte shuffles: sixteen characters become four words in a handful of vector instructions, and eight words become thirty-two characters. SnakeResponder answers a whole batch of messages through these block codecs and the batch pipeline, writing every response into one buffer that it reuses from call to call.
+
+#if ONEGOD_X86
+// Byte shuffles need SSSE3; honour the ONEGOD_SIMD cap like the batch kernels
+bool hex_simd_available() {
+    static const bool available = simd_level() >= SimdLevel::AVX2
+        || (simd_level() == SimdLevel::SSE2 && __builtin_cpu_supports("ssse3"));
+    return available;
+}
+
+// Four tokens (16 characters) per register; stops before the first register
+// holding a character that is not a hex digit and returns how many tokens it decoded
+__attribute__((target("ssse3")))
+size_t decode_hex4_ssse3(const char* text, size_t count, uint16_t* out) {
+    const __m128i pack_words = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 4 * i));
+        __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+        __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+        __m128i is_letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+        if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xFFFF) {
+            break;
+        }
+        __m128i nibbles = _mm_or_si128(_mm_and_si128(is_digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                                       _mm_andnot_si128(is_digit, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+        // Digit pairs to bytes (16 * high + low), then byte pairs to words (256 * high + low)
+        __m128i bytes = _mm_maddubs_epi16(nibbles, _mm_set1_epi16(0x0110));
+        __m128i words = _mm_madd_epi16(bytes, _mm_set1_epi32(0x00010100));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_shuffle_epi8(words, pack_words));
+    }
+    return i;
+}
+
+// Eight words (32 characters) per register
+__attribute__((target("ssse3")))
+size_t encode_hex4_ssse3(const uint16_t* words, size_t count, char* text) {
+    const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i most_significant_first = _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i));
+        __m128i high = _mm_and_si128(_mm_srli_epi16(x, 4), nibble_mask);  // nibbles 1 and 3
+        __m128i low = _mm_and_si128(x, nibble_mask);                       // nibbles 0 and 2
+        // Interleaving gives each token as nibbles 1 0 3 2; swapping its halves gives 3 2 1 0
+        __m128i first = _mm_shuffle_epi8(_mm_unpacklo_epi8(high, low), most_significant_first);
+        __m128i second = _mm_shuffle_epi8(_mm_unpackhi_epi8(high, low), most_significant_first);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(text + 4 * i), _mm_shuffle_epi8(digits, first));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(text + 4 * i + 16), _mm_shuffle_epi8(digits, second));
+    }
+    return i;
+}
+#endif
+
+// Decode 'count' packed 4-character tokens. Returns the index of the first
+// malformed token, or 'count' when every token is valid.
+size_t decode_hex4_block(const char* text, size_t count, uint16_t* out) {
+    size_t i = 0;
+#if ONEGOD_X86
+    if (hex_simd_available()) {
+        i = decode_hex4_ssse3(text, count, out);
+    }
+#endif
+    for (; i < count; ++i) {
+        if (!parse_hex_word(string_view(text + 4 * i, 4), out[i])) {
+            return i;
+        }
+    }
+    return count;
+}
+
+// Encode 'count' words as packed 4-character lowercase tokens
+void encode_hex4_block(const uint16_t* words, size_t count, char* text) {
+    size_t i = 0;
+#if ONEGOD_X86
+    if (hex_simd_available()) {
+        i = encode_hex4_ssse3(words, count, text);
+    }
+#endif
+    for (; i < count; ++i) {
+        format_hex_word(words[i], text + 4 * i);
+    }
+}
+
+// Answers batches of messages the way snakeA_response/snakeB_response answer one,
+// numbering messages on its own stream. Buffers grow to the largest batch seen
+// and are reused afterwards.
+class SnakeResponder {
+public:
+    SnakeResponder(string name, uint64_t stream) : name(name), stream(stream), messages_answered(0) {}
+
+    // The returned views point into this responder and stay valid until the next call.
+    // Throws invalid_argument naming the first malformed message; nothing is transformed then.
+    span<const string_view> respond(span<const string_view> messages) {
+        const size_t count = messages.size();
+        packed.resize(4 * count);
+        words.resize(count);
+        text.resize(4 * count);
+        responses.resize(count);
+
+        // Left-pad every message to four digits so the block decoder sees fixed-width tokens
+        for (size_t i = 0; i < count; ++i) {
+            const string_view message = messages[i];
+            if (message.empty() || message.size() > 4) {
+                throw malformed(i, message);
+            }
+            char* token = &packed[4 * i];
+            memset(token, '0', 4 - message.size());
+            memcpy(token + 4 - message.size(), message.data(), message.size());
+        }
+        size_t bad = decode_hex4_block(packed.data(), count, words.data());
+        if (bad < count) {
+            throw malformed(bad, messages[bad]);
+        }
+
+        snake_transformation_pipeline_batch(words, words, messages_answered, stream);
+        messages_answered += count;
+        encode_hex4_block(words.data(), count, text.data());
+        for (size_t i = 0; i < count; ++i) {
+            responses[i] = string_view(text.data() + 4 * i, 4);
+        }
+        return responses;
+    }
+
+private:
+    invalid_argument malformed(size_t index, string_view message) const {
+        return invalid_argument(name + " received a malformed message at index " + to_string(index)
+                                + ": '" + string(message) + "'");
+    }
+
+    string name;
+    uint64_t stream;
+    uint64_t messages_answered;
+    string packed;               // Input tokens, 4 characters each
+    vector<uint16_t> words;
+    string text;                 // Responses, 4 characters each
+    vector<string_view> responses;
+};
+
+f. Streaming Engine: Ordered Results from Many Cores
+
+The streaming engine feeds captures of any length through the batch pipeline. One thread reads the input in large chunks and writes the results; a work-stealing pool decodes, transforms and encodes the chunks in between. Results leave in input order, and only a fixed window of chunks is ever in flight, so memory stays bounded however long the stream runs.
+
+// Threads for worker_pool(): --threads, else $ONEGOD_THREADS, else one per hardware thread
+unsigned& requested_worker_threads() {
+    static unsigned threads = 0;
+    return threads;
+}
+
+unsigned parse_thread_count(string_view text, const string& source) {
+    unsigned threads = 0;
+    auto [end, error] = from_chars(text.data(), text.data() + text.size(), threads);
+    if (error != errc() || end != text.data() + text.size() || threads == 0 || threads > 1024) {
+        throw invalid_argument(source + ": expected a thread count from 1 to 1024, got '" + string(text) + "'");
+    }
+    return threads;
+}
+
+unsigned worker_thread_count() {
+    if (requested_worker_threads() > 0) {
+        return requested_worker_threads();
+    }
+    if (const char* env = getenv("ONEGOD_THREADS")) {
+        return parse_thread_count(env, "ONEGOD_THREADS");
+    }
+    return max(thread::hardware_concurrency(), 1u);
+}
+
+// A fixed set of workers, each with its own task queue. A worker takes the oldest
+// task from its own queue and, once that is empty, steals the oldest task from the
+// others, so chunks submitted in order also finish roughly in order.
+// Tasks must not throw; parallel_for catches and forwards exceptions itself.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads) : queues(threads) {
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back([this, i] { run_worker(i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            lock_guard<mutex> lock(sleep_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    unsigned size() const {
+        return static_cast<unsigned>(queues.size());
+    }
+
+    // Tasks submitted from one of this pool's workers go to its own queue; others are dealt round-robin
+    void submit(function<void()> task) {
+        size_t target = current_pool == this ? current_worker
+                                             : next_queue.fetch_add(1, memory_order_relaxed) % queues.size();
+        {
+            lock_guard<mutex> lock(queues[target].guard);
+            queues[target].tasks.push_back(move(task));
+        }
+        queued.fetch_add(1);
+        // Taking the lock orders this against a worker checking 'queued' before it sleeps
+        {
+            lock_guard<mutex> lock(sleep_mutex);
+        }
+        wake.notify_one();
+    }
+
+    // Run body(begin, end) over [0, count) in ranges of at least 'grain' items and return
+    // once all of them are done, rethrowing the first exception a range threw. Called from
+    // one of this pool's own tasks it runs the whole range inline rather than wait on itself.
+    template<typename Body>
+    void parallel_for(size_t count, size_t grain, const Body& body) {
+        if (count == 0) {
+            return;
+        }
+        if (current_pool == this || size() == 1) {
+            body(size_t{ 0 }, count);
+            return;
+        }
+        const size_t ranges = min((count + grain - 1) / max(grain, size_t{ 1 }), size_t{ 4 } * size());
+        latch done(static_cast<ptrdiff_t>(ranges));
+        mutex error_mutex;
+        exception_ptr error;
+        for (size_t r = 0; r < ranges; ++r) {
+            const size_t begin = count / ranges * r + min(r, count % ranges);
+            const size_t end = begin + count / ranges + (r < count % ranges ? 1 : 0);
+            submit([&, begin, end] {
+                try {
+                    body(begin, end);
+                } catch (...) {
+                    lock_guard<mutex> lock(error_mutex);
+                    if (!error) {
+                        error = current_exception();
+                    }
+                }
+                done.count_down();
+            });
+        }
+        done.wait();
+        if (error) {
+            rethrow_exception(error);
+        }
+    }
+
+private:
+    struct alignas(64) TaskQueue {
+        mutex guard;
+        deque<function<void()>> tasks;
+    };
+
+    bool take_task(unsigned self, function<void()>& task) {
+        for (size_t k = 0; k < queues.size(); ++k) {
+            TaskQueue& queue = queues[(self + k) % queues.size()];
+            lock_guard<mutex> lock(queue.guard);
+            if (!queue.tasks.empty()) {
+                task = move(queue.tasks.front());
+                queue.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run_worker(unsigned self) {
+        current_pool = this;
+        current_worker = self;
+        function<void()> task;
+        while (true) {
+            if (take_task(self, task)) {
+                queued.fetch_sub(1);
+                task();
+                task = nullptr;
+                continue;
+            }
+            unique_lock<mutex> lock(sleep_mutex);
+            wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+            if (stopping && queued.load() <= 0) {
+                return;
+            }
+        }
+    }
+
+    inline static thread_local const WorkStealingPool* current_pool = nullptr;
+    inline static thread_local unsigned current_worker = 0;
+
+    vector<TaskQueue> queues;
+    atomic<size_t> next_queue{ 0 };
+    atomic<long> queued{ 0 };    // Tasks submitted and not yet taken
+    mutex sleep_mutex;
+    condition_variable wake;
+    bool stopping = false;
+    vector<thread> workers;
+};
+
+// The shared pool, started with worker_thread_count() threads on first use
+WorkStealingPool& worker_pool() {
+    static WorkStealingPool pool(worker_thread_count());
+    return pool;
+}
+
+// Owns a file descriptor and closes it on scope exit; standard streams are never closed
+class UniqueFd {
+public:
+    explicit UniqueFd(int fd = -1) : fd(fd) {}
+    UniqueFd(const UniqueFd&) = delete;
+    UniqueFd& operator=(const UniqueFd&) = delete;
+    ~UniqueFd() {
+        if (fd > STDERR_FILENO) {
+            close(fd);
+        }
+    }
+
+    int get() const { return fd; }
+
+private:
+    int fd;
+};
+
+runtime_error system_error_for(const string& what) {
+    return runtime_error(what + ": " + strerror(errno));
+}
+
+// Open a file for sequential reading; an empty path or "-" means stdin
+UniqueFd open_input(const string& path) {
+    if (path.empty() || path == "-") {
+        return UniqueFd(STDIN_FILENO);
+    }
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw system_error_for(path);
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return UniqueFd(fd);
+}
+
+// read() until 'size' bytes arrive or the input ends; returns the bytes read
+size_t read_fully(int fd, char* buffer, size_t size, const string& source) {
+    size_t filled = 0;
+    while (filled < size) {
+        ssize_t n = read(fd, buffer + filled, size - filled);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            throw system_error_for(source);
+        }
+        if (n == 0) {
+            break;
+        }
+        filled += static_cast<size_t>(n);
+    }
+    return filled;
+}
+
+void write_fully(int fd, const char* data, size_t size, const string& sink) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            throw system_error_for(sink);
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+// HEX: one word of 1-4 hex digits per line ('\r\n' accepted), answered as 4 digits per line.
+// BINARY: little-endian 16-bit words in and out.
+enum class StreamFormat { HEX, BINARY };
+
+// Sees each chunk's words before and after the pipeline, e.g. to store them (see Result Store)
+using StreamRecorder = function<void(span<const uint16_t> inputs, span<const uint16_t> outputs, uint64_t first_index)>;
+
+struct StreamOptions {
+    StreamFormat format = StreamFormat::HEX;
+    size_t chunk_bytes = size_t{ 4 } << 20;    // Input bytes per chunk
+    uint64_t stream = SNAKE_B_STREAM;          // Quantum stream the words are measured on
+    StreamRecorder record;                     // Called on the worker for every chunk, when set
+};
+
+struct StreamStats {
+    uint64_t words = 0;
+    uint64_t chunks = 0;
+};
+
+// One chunk of the stream, its scratch buffers and its result. Chunks are recycled,
+// so the buffers only grow while the stream warms up.
+struct StreamChunk {
+    vector<uint16_t> raw;        // Input bytes; binary chunks are transformed here in place
+    size_t size = 0;             // Input bytes in this chunk
+    uint64_t first_index = 0;    // Stream index of the first word, which for hex is also its line
+    size_t word_count = 0;
+    vector<uint16_t> words;
+    vector<uint16_t> inputs;     // The words before the pipeline, kept only for a recorder
+    string packed;               // 4-character tokens
+    string text;                 // Hex output lines
+    const char* output = nullptr;
+    size_t output_size = 0;
+    exception_ptr error;
+    atomic<bool> done{ false };
+
+    char* bytes() {
+        return reinterpret_cast<char*>(raw.data());
+    }
+};
+
+void transform_hex_chunk(StreamChunk& chunk, const CompiledPipeline& pipeline, uint64_t stream, const string& source,
+                         const StreamRecorder& record) {
+    const char* line = chunk.bytes();
+    const char* const end = line + chunk.size;
+    // Every line but the last takes at least two bytes
+    const size_t max_words = chunk.size / 2 + 1;
+    chunk.packed.resize(4 * max_words);
+    chunk.words.resize(max_words);
+
+    size_t count = 0;
+    while (line < end) {
+        char* token = &chunk.packed[4 * count];
+        // Fast path for the usual 4-digit line; anything else, a shorter line ending in '\r\n' included, goes through
+        // the general parse
+        if (end - line > 4 && line[4] == '\n' && line[0] != '\n' && line[1] != '\n' && line[2] != '\n' && line[3] != '\n'
+            && line[3] != '\r') {
+            memcpy(token, line, 4);
+            line += 5;
+        } else {
+            const char* newline = static_cast<const char*>(memchr(line, '\n', end - line));
+            const char* line_end = newline ? newline : end;
+            size_t length = line_end - line;
+            if (length > 0 && line[length - 1] == '\r') {
+                --length;
+            }
+            if (length == 0 || length > 4) {
+                throw runtime_error(source + ":" + to_string(chunk.first_index + count + 1)
+                                    + ": expected 1-4 hex digits, got '" + string(line, min<size_t>(length, 16)) + "'");
+            }
+            memset(token, '0', 4 - length);
+            memcpy(token + 4 - length, line, length);
+            line = newline ? newline + 1 : end;
+        }
+        ++count;
+    }
+
+    size_t bad = decode_hex4_block(chunk.packed.data(), count, chunk.words.data());
+    if (bad < count) {
+        // Find the offending line again to quote it as written
+        const char* text = chunk.bytes();
+        for (size_t i = 0; i < bad; ++i) {
+            text = static_cast<const char*>(memchr(text, '\n', end - text)) + 1;
+        }
+        const char* newline = static_cast<const char*>(memchr(text, '\n', end - text));
+        string written(text, newline ? newline : end);
+        if (!written.empty() && written.back() == '\r') {
+            written.pop_back();
+        }
+        throw runtime_error(source + ":" + to_string(chunk.first_index + bad + 1) + ": malformed hex word '" + written + "'");
+    }
+    span<uint16_t> words(chunk.words.data(), count);
+    if (record) {
+        chunk.inputs.assign(words.begin(), words.end());
+    }
+    snake_transformation_pipeline_batch(pipeline, words, words, chunk.first_index, stream);
+    if (record) {
+        record(chunk.inputs, words, chunk.first_index);
+    }
+
+    encode_hex4_block(chunk.words.data(), count, chunk.packed.data());
+    chunk.text.resize(5 * count);
+    for (size_t i = 0; i < count; ++i) {
+        memcpy(&chunk.text[5 * i], &chunk.packed[4 * i], 4);
+        chunk.text[5 * i + 4] = '\n';
+    }
+    chunk.word_count = count;
+    chunk.output = chunk.text.data();
+    chunk.output_size = chunk.text.size();
+}
+
+void transform_binary_chunk(StreamChunk& chunk, const CompiledPipeline& pipeline, uint64_t stream, const StreamRecorder& record) {
+    const size_t count = chunk.size / 2;
+    span<uint16_t> words(chunk.raw.data(), count);
+    if constexpr (endian::native == endian::big) {
+        for (auto& word : words) word = __builtin_bswap16(word);
+    }
+    if (record) {
+        chunk.inputs.assign(words.begin(), words.end());
+    }
+    snake_transformation_pipeline_batch(pipeline, words, words, chunk.first_index, stream);
+    if (record) {
+        record(chunk.inputs, words, chunk.first_index);
+    }
+    if constexpr (endian::native == endian::big) {
+        for (auto& word : words) word = __builtin_bswap16(word);
+    }
+    chunk.word_count = count;
+    chunk.output = chunk.bytes();
+    chunk.output_size = 2 * count;
+}
+
+// Stream every word from in_fd through the pipeline to out_fd, in input order. Word i of
+// the stream is measured at index i, so the output does not depend on the thread count or
+// chunk size. Throws runtime_error naming the source and line of the first malformed hex
+// word (or an odd trailing byte in binary input); earlier chunks have been written by then.
+StreamStats run_stream(int in_fd, int out_fd, const string& source, const CompiledPipeline& pipeline,
+                       const StreamOptions& options, WorkStealingPool& pool) {
+    const bool hex = options.format == StreamFormat::HEX;
+    const size_t capacity = max(options.chunk_bytes, size_t{ 64 }) & ~size_t{ 1 };
+    const size_t window = 2 * size_t{ pool.size() } + 2;
+    deque<unique_ptr<StreamChunk>> in_flight;
+    vector<unique_ptr<StreamChunk>> spare;
+    string carry;    // Bytes after the last complete line or word, prepended to the next chunk
+    bool at_end = false;
+    uint64_t next_index = 0;
+    StreamStats stats;
+
+    try {
+        while (true) {
+            while (!at_end && in_flight.size() < window) {
+                unique_ptr<StreamChunk> chunk;
+                if (spare.empty()) {
+                    chunk = make_unique<StreamChunk>();
+                    chunk->raw.resize(capacity / 2);
+                } else {
+                    chunk = move(spare.back());
+                    spare.pop_back();
+                }
+                char* buffer = chunk->bytes();
+                memcpy(buffer, carry.data(), carry.size());
+                const size_t filled = carry.size() + read_fully(in_fd, buffer + carry.size(), capacity - carry.size(), source);
+                at_end = filled < capacity;
+
+                size_t size = filled;
+                if (!hex) {
+                    if (at_end && filled % 2 != 0) {
+                        throw runtime_error(source + ": binary stream ends with an odd trailing byte");
+                    }
+                    size = filled & ~size_t{ 1 };
+                } else if (!at_end) {
+                    // Cut after the last newline; a chunk without one is left whole for the parser to reject
+                    size_t cut = filled;
+                    while (cut > 0 && buffer[cut - 1] != '\n') {
+                        --cut;
+                    }
+                    size = cut > 0 ? cut : filled;
+                }
+                carry.assign(buffer + size, filled - size);
+                if (size == 0) {
+                    spare.push_back(move(chunk));
+                    continue;
+                }
+
+                chunk->size = size;
+                chunk->first_index = next_index;
+                next_index += hex ? count(buffer, buffer + size, '\n') + (buffer[size - 1] != '\n' ? 1 : 0) : size / 2;
+                chunk->error = nullptr;
+                chunk->done.store(false, memory_order_relaxed);
+                StreamChunk* job = chunk.get();
+                in_flight.push_back(move(chunk));
+                pool.submit([job, hex, &pipeline, &options, &source] {
+                    try {
+                        if (hex) {
+                            transform_hex_chunk(*job, pipeline, options.stream, source, options.record);
+                        } else {
+                            transform_binary_chunk(*job, pipeline, options.stream, options.record);
+                        }
+                    } catch (...) {
+                        job->error = current_exception();
+                    }
+                    job->done.store(true, memory_order_release);
+                    job->done.notify_one();
+                });
+            }
+            if (in_flight.empty()) {
+                break;
+            }
+
+            StreamChunk& front = *in_flight.front();
+            front.done.wait(false, memory_order_acquire);
+            if (front.error) {
+                rethrow_exception(front.error);
+            }
+            write_fully(out_fd, front.output, front.output_size, "output");
+            stats.words += front.word_count;
+            ++stats.chunks;
+            spare.push_back(move(in_flight.front()));
+            in_flight.pop_front();
+        }
+    } catch (...) {
+        // Workers still hold pointers into the in-flight chunks
+        for (auto& chunk : in_flight) {
+            chunk->done.wait(false, memory_order_acquire);
+        }
+        throw;
+    }
+    return stats;
+}
+
+Note: each chunk's first index comes from counting the newlines before it, which the reading thread does as it cuts the chunks. That count is the only serial pass over the input besides the read itself; decoding, the pipeline and encoding all run on the pool.
+
+g. Memory-Mapped File Encryption
+
+--encrypt-file treats a whole file as an array of little-endian 16-bit words and runs the batch pipeline over it where it lies in the page cache: the input is mapped, the output is either the same mapping (in place) or a second mapped file of the same size, and the pool works through contiguous ranges of words so every thread reads and writes sequentially. Word i is measured at index i on Snake B's stream, so for even-length files the result is byte for byte what --stream --binary produces. Only a cipher-mode pipeline is accepted: the quantum stage throws its input away, and an in-place run would leave a file that nothing can decrypt.
+
+Padding rule for an odd trailing byte: the file is never grown. Once the whole words are done, the last byte is covered by one extra word that overlaps the end of the last whole word, made of bytes n-2 and n-1 of the partly transformed file and measured at index n/2. A one-byte file has no word to overlap; its byte is XORed with the low byte of the measurement bits for word 0, so it too can be decrypted.
+
+// A shared read-only or read-write mapping of a whole file, unmapped on scope exit
+class MappedFile {
+public:
+    MappedFile(int fd, size_t size, bool writable, const string& path) : bytes(nullptr), length(size) {
+        if (length == 0) {
+            return;
+        }
+        void* mapped = mmap(nullptr, length, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            throw system_error_for(path);
+        }
+        bytes = static_cast<uint8_t*>(mapped);
+        madvise(bytes, length, MADV_SEQUENTIAL);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() {
+        if (bytes) {
+            munmap(bytes, length);
+        }
+    }
+
+    uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    uint8_t* bytes;
+    size_t length;
+};
+
+// Transform 'count' little-endian words from 'in' into 'out' (which may be 'in') starting at 'first_index'
+void transform_le_words(const CompiledPipeline& pipeline, const uint8_t* in, uint8_t* out, size_t count,
+                        uint64_t first_index, uint64_t stream) {
+    // mmap'd pages are page aligned and carry no other object type, so the words can be used where they lie
+    span<const uint16_t> source(reinterpret_cast<const uint16_t*>(in), count);
+    span<uint16_t> target(reinterpret_cast<uint16_t*>(out), count);
+    if constexpr (endian::native == endian::little) {
+        snake_transformation_pipeline_batch(pipeline, source, target, first_index, stream);
+    } else {
+        for (size_t i = 0; i < count; ++i) target[i] = __builtin_bswap16(source[i]);
+        snake_transformation_pipeline_batch(pipeline, target, target, first_index, stream);
+        for (auto& word : target) word = __builtin_bswap16(word);
+    }
+}
+
+struct FileCipherStats {
+    uint64_t bytes = 0;
+    uint64_t words = 0;    // Pipeline words run, including the padding word for an odd length
+};
+
+// The input of a file transform and where its result goes: the same read-write mapping
+// in place, or a read-only input beside an output created (or truncated) at the input's
+// size. An output naming the input file itself counts as in place.
+class MappedFilePair {
+public:
+    MappedFilePair(const string& input_path, const string& output_path)
+        : in_place(output_path.empty() || same_file(input_path, output_path)),
+          input(open_or_throw(input_path, in_place ? O_RDWR : O_RDONLY)),
+          length(regular_file_size(input.get(), input_path)),
+          output(in_place ? -1 : create_output(output_path, length)),
+          source(input.get(), length, in_place, input_path),
+          target(output.get(), in_place ? 0 : length, true, output_path) {}
+
+    const uint8_t* in() const { return source.data(); }
+    uint8_t* out() const { return in_place ? source.data() : target.data(); }
+    size_t size() const { return length; }
+
+private:
+    static bool same_file(const string& a, const string& b) {
+        struct stat sa, sb;
+        return stat(a.c_str(), &sa) == 0 && stat(b.c_str(), &sb) == 0 && sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+    }
+
+    static int open_or_throw(const string& path, int flags) {
+        int fd = open(path.c_str(), flags);
+        if (fd < 0) {
+            throw system_error_for(path);
+        }
+        return fd;
+    }
+
+    static size_t regular_file_size(int fd, const string& path) {
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            throw system_error_for(path);
+        }
+        if (!S_ISREG(info.st_mode)) {
+            throw runtime_error(path + ": not a regular file");
+        }
+        return static_cast<size_t>(info.st_size);
+    }
+
+    static int create_output(const string& path, size_t size) {
+        int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0 || ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            int error = errno;
+            if (fd >= 0) {
+                close(fd);
+            }
+            errno = error;
+            throw system_error_for(path);
+        }
+        return fd;
+    }
+
+    bool in_place;
+    UniqueFd input;
+    size_t length;
+    UniqueFd output;
+    MappedFile source;
+    MappedFile target;
+};
+
+// The one-byte file of the padding rule: XOR with the low byte of word 0's measurement bits
+uint8_t single_byte_key(const CompiledPipeline& pipeline, uint64_t stream) {
+    return static_cast<uint8_t>(quantum_bits(QuantumKey{ pipeline.seed, stream }, 0));
+}
+
+// Encrypt 'input_path' in place, or into 'output_path' when one is given. Throws
+// invalid_argument, before touching either file, unless the pipeline is in cipher mode.
+FileCipherStats encrypt_file(const string& input_path, const string& output_path, const CompiledPipeline& pipeline,
+                             uint64_t stream, WorkStealingPool& pool) {
+    if (pipeline.mode != PipelineMode::CIPHER) {
+        throw invalid_argument("--encrypt-file: the quantum stage discards its input, so the file could never be decrypted; "
+                               "use --cipher (or mode cipher in the spec)");
+    }
+    MappedFilePair files(input_path, output_path);
+    const uint8_t* in = files.in();
+    uint8_t* out = files.out();
+    const size_t size = files.size();
+    const size_t words = size / 2;
+
+    FileCipherStats stats;
+    stats.bytes = size;
+    stats.words = words;
+    pool.parallel_for(words, size_t{ 1 } << 18, [&](size_t begin, size_t end) {
+        transform_le_words(pipeline, in + 2 * begin, out + 2 * begin, end - begin, begin, stream);
+    });
+
+    if (size == 1) {
+        out[0] = in[0] ^ single_byte_key(pipeline, stream);
+    } else if (size % 2 != 0) {
+        // The overlapping word from the padding rule, taken after the whole words are done
+        uint16_t word = pipeline.run(static_cast<uint16_t>(out[size - 2] | in[size - 1] << 8), words, stream);
+        out[size - 2] = static_cast<uint8_t>(word);
+        out[size - 1] = static_cast<uint8_t>(word >> 8);
+        ++stats.words;
+    }
+    return stats;
+}
+
+// Undo encrypt_file, given the compile_inverse_pipeline() of the pipeline that encrypted.
+// The overlapping word of an odd-length file is undone first, giving back the encrypted
+// high byte of the last whole word before that word is undone in turn.
+FileCipherStats decrypt_file(const string& input_path, const string& output_path, const CompiledPipeline& inverse,
+                             uint64_t stream, WorkStealingPool& pool) {
+    MappedFilePair files(input_path, output_path);
+    const uint8_t* in = files.in();
+    uint8_t* out = files.out();
+    const size_t size = files.size();
+    const size_t words = size / 2;
+
+    FileCipherStats stats;
+    stats.bytes = size;
+    stats.words = words;
+    if (size == 1) {
+        out[0] = in[0] ^ single_byte_key(inverse, stream);
+        return stats;
+    }
+    if (size % 2 == 0) {
+        pool.parallel_for(words, size_t{ 1 } << 18, [&](size_t begin, size_t end) {
+            transform_le_words(inverse, in + 2 * begin, out + 2 * begin, end - begin, begin, stream);
+        });
+        return stats;
+    }
+
+    // Odd length: bytes n-2 and n-1 hold the overlapping word; the last whole word ends at n-2
+    const uint16_t overlap = inverse.run(static_cast<uint16_t>(in[size - 2] | in[size - 1] << 8), words, stream);
+    pool.parallel_for(words - 1, size_t{ 1 } << 18, [&](size_t begin, size_t end) {
+        transform_le_words(inverse, in + 2 * begin, out + 2 * begin, end - begin, begin, stream);
+    });
+    const uint16_t last = inverse.run(static_cast<uint16_t>(in[size - 3] | (overlap & 0xFF) << 8), words - 1, stream);
+    out[size - 3] = static_cast<uint8_t>(last);
+    out[size - 2] = static_cast<uint8_t>(last >> 8);
+    out[size - 1] = static_cast<uint8_t>(overlap >> 8);
+    ++stats.words;
+    return stats;
+}
+
+h. Wide Words: Folding and Batching 32-, 64- and 128-bit Pipelines
+
+Every operation but gfmul is a rotation or an XOR with a constant, at any word width, so any run of them folds to a single rotl(w, r) ⊕ c. Wider words skip the matrices and lookup tables that serve 16-bit words (a 2^32-entry table is out of the question) and keep just that rotation and constant; the batch loop then does one shift pair and two XORs per word around the measurement, a loop the compiler vectorizes over whole registers of 32- and 64-bit lanes. A pipeline with a gfmul in front of the quantum stage cannot be folded this way, so in cipher mode, where that half of the pipeline matters, its operations are kept and interpreted word by word instead.
+
+// f(w) = rotl(w, rotation) ⊕ constant
+template <PipelineWord Word>
+struct RotateXorMap {
+    int rotation = 0;
+    Word constant = 0;
+
+    Word apply(Word word) const {
+        return static_cast<Word>(rotate_left(word, rotation) ^ constant);
+    }
+
+    // Apply this map first, then op (a rotation or XOR-like operation, not GFMUL)
+    RotateXorMap then(const BasicOp<Word>& op) const {
+        RotateXorMap next = *this;
+        switch (op.code) {
+            case OpCode::ROTL:
+                next.rotation = (rotation + static_cast<int>(op.imm)) & (WORD_BITS<Word> - 1);
+                next.constant = rotate_left(constant, static_cast<int>(op.imm));
+                break;
+            case OpCode::ROTR:
+                next.rotation = (rotation - static_cast<int>(op.imm)) & (WORD_BITS<Word> - 1);
+                next.constant = rotate_right(constant, static_cast<int>(op.imm));
+                break;
+            default:
+                next.constant = execute(op, constant);
+                break;
+        }
+        return next;
+    }
+};
+
+// The pipeline folded for a word width: RotateXorMaps on either side of the quantum stage
+template <PipelineWord Word>
+struct CompiledWidePipeline {
+    RotateXorMap<Word> pre_quantum;
+    RotateXorMap<Word> post_quantum;
+    uint64_t seed;
+    PipelineMode mode;
+    vector<BasicOp<Word>> unfolded;     // When pre_quantum cannot hold the front half: its operations, run before it
+
+    Word pre_quantum_apply(Word word) const {
+        for (const auto& op : unfolded) {
+            word = execute(op, word);
+        }
+        return pre_quantum.apply(word);
+    }
+
+    Word run(Word word, uint64_t index = 0, uint64_t stream = 0) const {
+        word = pre_quantum_apply(word);
+        word = mode == PipelineMode::CIPHER ? static_cast<Word>(word ^ quantum_word<Word>(QuantumKey{ seed, stream }, index))
+                                            : quantum_measure(word, QuantumKey{ seed, stream }, index);
+        return post_quantum.apply(word);
+    }
+};
+
+template <PipelineWord Word>
+CompiledWidePipeline<Word> compile_wide_pipeline(const BasicPipelineConfig<Word>& config) {
+    CompiledWidePipeline<Word> compiled{ {}, {}, config.seed, config.mode, {} };
+    for (const auto& transformer : config.transformers) {
+        for (const auto& op : transformer.fused) {
+            if (op.code == OpCode::GFMUL || !compiled.unfolded.empty()) {
+                compiled.unfolded.push_back(op);
+            } else {
+                compiled.pre_quantum = compiled.pre_quantum.then(op);
+            }
+        }
+    }
+    if (!compiled.unfolded.empty()) {
+        // Keep the operations folded so far in front of the unfolded ones
+        const RotateXorMap<Word> folded = compiled.pre_quantum;
+        compiled.unfolded.insert(compiled.unfolded.begin(),
+                                 { BasicOp<Word>::rotate_left(folded.rotation), BasicOp<Word>::xor_with_key(folded.constant) });
+        compiled.pre_quantum = {};
+    }
+    for (const auto& cp : config.crowned_primes) {
+        compiled.pre_quantum.constant ^= wrapping_multiply<Word>(static_cast<Word>(cp.prime), cp.weight);
+    }
+    compiled.post_quantum.constant = config.final_reflector;
+    return compiled;
+}
+
+// Compiled once from active_pipeline_as<Word>() on first use
+template <PipelineWord Word>
+const CompiledWidePipeline<Word>& active_compiled_wide_pipeline() {
+    static const CompiledWidePipeline<Word> compiled = compile_wide_pipeline(active_pipeline_as<Word>());
+    return compiled;
+}
+
+// The batch entry point for wider words, with the same contract as the 16-bit one:
+// in[i] is word first_index + i of the stream and 'out' may alias 'in'
+template <PipelineWord Word>
+void snake_transformation_pipeline_batch(const CompiledWidePipeline<Word>& pipeline, type_identity_t<span<const Word>> in,
+                                         type_identity_t<span<Word>> out, uint64_t first_index = 0, uint64_t stream = 0) {
+    if (out.size() < in.size()) {
+        throw invalid_argument("snake_transformation_pipeline_batch: output span is shorter than input");
+    }
+    const uint64_t base = quantum_stream_base(QuantumKey{ pipeline.seed, stream });
+    const int rotation = pipeline.pre_quantum.rotation;
+    const Word pre = pipeline.pre_quantum.constant;
+    const Word post = pipeline.post_quantum.constant;
+    const size_t count = in.size();
+    if (pipeline.mode == PipelineMode::CIPHER && !pipeline.unfolded.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = static_cast<Word>(pipeline.pre_quantum_apply(in[i]) ^ quantum_word_from_base<Word>(base, first_index + i) ^ post);
+        }
+    } else if (pipeline.mode == PipelineMode::CIPHER) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = static_cast<Word>(rotate_left(in[i], rotation) ^ pre ^ quantum_word_from_base<Word>(base, first_index + i) ^ post);
+        }
+    } else {
+        // The measurement replaces the word, so only the final reflection survives
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = static_cast<Word>(quantum_word_from_base<Word>(base, first_index + i) ^ post);
+        }
+    }
+}
+
+i. Verification Engine: Golden Files and the Exhaustive Sweep
+
+Regression checks run on the pool and report every mismatch rather than the first. A golden file lists one test vector per line, an input word and the expected response in hex, optionally followed by the word's index in its stream (by default, its position among the vectors), with # starting a comment. Output from --stream has exactly these semantics, so pasting a capture beside its answers gives a golden file. The sweep needs no file at all: it runs all 65536 inputs through the compiled pipeline and through a reference that interprets every operation as written, one word at a time, and in cipher mode also decrypts the result and expects the input back. It also runs the inputs through the bitsliced form of the folded transformers and crowns and checks it against their lookup table.
+
+struct GoldenVector {
+    uint64_t line;      // 1-based line in the golden file
+    uint64_t index;     // Stream index the word is measured at
+    uint16_t input;
+    uint16_t expected;
+};
+
+struct Mismatch {
+    uint64_t line;      // Golden-file line, or 0 in a sweep
+    uint64_t index;
+    uint16_t input;
+    uint16_t expected;
+    uint16_t actual;
+    const char* check;  // Which comparison failed
+};
+
+struct VerificationReport {
+    uint64_t checked = 0;
+    vector<Mismatch> mismatches;    // In input order
+
+    bool passed() const { return mismatches.empty(); }
+};
+
+// "checked N, M mismatched" and then up to 'limit' mismatches, one compact row each,
+// with the bits that differ so systematic errors stand out
+void print_report(ostream& out, string_view title, const VerificationReport& report, size_t limit = 20) {
+    out << title << ": checked " << report.checked << ", " << report.mismatches.size() << " mismatched\n";
+    if (report.mismatches.empty()) {
+        return;
+    }
+    out << "  line       index      input expected actual diff  check\n";
+    for (size_t i = 0; i < report.mismatches.size() && i < limit; ++i) {
+        const Mismatch& m = report.mismatches[i];
+        char row[128];
+        snprintf(row, sizeof(row), "  %-10llu %-10llu %04x  %04x     %04x   %04x  %s\n", static_cast<unsigned long long>(m.line),
+                 static_cast<unsigned long long>(m.index), m.input, m.expected, m.actual, m.expected ^ m.actual, m.check);
+        out << row;
+    }
+    if (report.mismatches.size() > limit) {
+        out << "  ... " << report.mismatches.size() - limit << " more\n";
+    }
+}
+
+// Run 'check(begin, end, found)' over [0, count) on the pool, each range appending its
+// mismatches to its own list, and merge the lists in range order
+template <typename Check>
+VerificationReport collect_mismatches(size_t count, WorkStealingPool& pool, const Check& check) {
+    mutex merge_mutex;
+    vector<pair<size_t, vector<Mismatch>>> found_by_range;
+    pool.parallel_for(count, 4096, [&](size_t begin, size_t end) {
+        vector<Mismatch> found;
+        check(begin, end, found);
+        if (!found.empty()) {
+            lock_guard<mutex> lock(merge_mutex);
+            found_by_range.emplace_back(begin, move(found));
+        }
+    });
+    sort(found_by_range.begin(), found_by_range.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    VerificationReport report;
+    report.checked = count;
+    for (auto& [begin, found] : found_by_range) {
+        report.mismatches.insert(report.mismatches.end(), found.begin(), found.end());
+    }
+    return report;
+}
+
+// Marks a vector without an explicit index until every chunk has been parsed
+const uint64_t NO_INDEX = ~uint64_t{ 0 };
+
+// Parse the golden lines in text[0, size), the first of which is line 'first_line'
+void parse_golden_lines(const char* text, size_t size, uint64_t first_line, const string& path, vector<GoldenVector>& vectors) {
+    const char* const end = text + size;
+    uint64_t line_number = first_line;
+    for (const char* line = text; line < end; ++line_number) {
+        const char* newline = static_cast<const char*>(memchr(line, '\n', end - line));
+        const char* line_end = newline ? newline : end;
+        const char* content_end = static_cast<const char*>(memchr(line, '#', line_end - line));
+        content_end = content_end ? content_end : line_end;
+
+        string_view fields[4];
+        size_t field_count = 0;
+        for (const char* c = line; c < content_end;) {
+            while (c < content_end && (*c == ' ' || *c == '\t' || *c == '\r')) ++c;
+            const char* start = c;
+            while (c < content_end && *c != ' ' && *c != '\t' && *c != '\r') ++c;
+            if (c > start && field_count < 4) {
+                fields[field_count] = string_view(start, c - start);
+            }
+            field_count += c > start ? 1 : 0;
+        }
+
+        if (field_count > 0) {
+            GoldenVector golden{ line_number, NO_INDEX, 0, 0 };
+            auto fail = [&](const string& what) {
+                return runtime_error(path + ":" + to_string(line_number) + ": " + what);
+            };
+            if (field_count < 2 || field_count > 3) {
+                throw fail("expected '<input> <expected> [index]'");
+            }
+            if (!parse_hex_word(fields[0], golden.input) || !parse_hex_word(fields[1], golden.expected)) {
+                throw fail("words must be 1-4 hex digits");
+            }
+            if (field_count == 3) {
+                auto [parsed_end, error] = from_chars(fields[2].data(), fields[2].data() + fields[2].size(), golden.index);
+                if (error != errc() || parsed_end != fields[2].data() + fields[2].size()) {
+                    throw fail("index must be a decimal number");
+                }
+            }
+            vectors.push_back(golden);
+        }
+        line = newline ? newline + 1 : end;
+    }
+}
+
+// Load a golden file, parsing newline-aligned chunks of it in parallel
+vector<GoldenVector> load_golden_file(const string& path, WorkStealingPool& pool) {
+    UniqueFd fd(open(path.c_str(), O_RDONLY));
+    struct stat info;
+    if (fd.get() < 0 || fstat(fd.get(), &info) != 0) {
+        throw system_error_for(path);
+    }
+    MappedFile file(fd.get(), static_cast<size_t>(info.st_size), false, path);
+    const char* text = reinterpret_cast<const char*>(file.data());
+    const size_t size = file.size();
+
+    // Chunk boundaries just after a newline
+    const size_t chunks = size == 0 ? 0 : min<size_t>(4 * pool.size(), size / 4096 + 1);
+    vector<size_t> bounds(chunks + 1, size);
+    bounds[0] = 0;
+    for (size_t k = 1; k < chunks; ++k) {
+        size_t cut = max(size * k / chunks, bounds[k - 1]);
+        const void* newline = cut < size ? memchr(text + cut, '\n', size - cut) : nullptr;
+        bounds[k] = newline ? static_cast<const char*>(newline) - text + 1 : size;
+    }
+
+    // Count lines per chunk for the line numbers, then parse every chunk on its own
+    vector<uint64_t> first_line(chunks + 1, 1);
+    pool.parallel_for(chunks, 1, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            first_line[k + 1] = count(text + bounds[k], text + bounds[k + 1], '\n');
+        }
+    });
+    for (size_t k = 1; k <= chunks; ++k) {
+        first_line[k] += first_line[k - 1];
+    }
+    vector<vector<GoldenVector>> parsed(chunks);
+    pool.parallel_for(chunks, 1, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            parse_golden_lines(text + bounds[k], bounds[k + 1] - bounds[k], first_line[k], path, parsed[k]);
+        }
+    });
+
+    vector<GoldenVector> vectors;
+    for (auto& chunk : parsed) {
+        vectors.insert(vectors.end(), chunk.begin(), chunk.end());
+    }
+    for (size_t i = 0; i < vectors.size(); ++i) {
+        if (vectors[i].index == NO_INDEX) {
+            vectors[i].index = i;
+        }
+    }
+    return vectors;
+}
+
+// Check every golden vector against the compiled pipeline on 'stream'
+VerificationReport verify_golden(const vector<GoldenVector>& vectors, const CompiledPipeline& pipeline, uint64_t stream,
+                                 WorkStealingPool& pool) {
+    return collect_mismatches(vectors.size(), pool, [&](size_t begin, size_t end, vector<Mismatch>& found) {
+        for (size_t i = begin; i < end; ++i) {
+            const GoldenVector& v = vectors[i];
+            uint16_t actual = pipeline.run(v.input, v.index, stream);
+            if (actual != v.expected) {
+                found.push_back({ v.line, v.index, v.input, v.expected, actual, "golden" });
+            }
+        }
+    });
+}
+
+// The pipeline straight from its definition: every operation as written, one word at a
+// time, with no fusion, folding, tables or vector kernels
+uint16_t reference_pipeline(const PipelineConfig& config, uint16_t word, uint64_t index, uint64_t stream) {
+    for (const auto& transformer : config.transformers) {
+        for (const Op& op : transformer.operations) {
+            word = execute(op, word);
+        }
+    }
+    word = apply_crowned_primes<TraceLevel::Silent>(word, config.crowned_primes);
+    word = quantum_inspired_transform<TraceLevel::Silent>(word, QuantumKey{ config.seed, stream }, index, config.mode);
+    return reflect(word, config.final_reflector);
+}
+
+// All 65536 inputs, input w measured at index w: the batch path against the reference,
+// the bitsliced pre-quantum map against its table, and in cipher mode the inverse
+// pipeline against the input
+VerificationReport sweep_against_reference(const PipelineConfig& config, const CompiledPipeline& pipeline, uint64_t stream,
+                                           WorkStealingPool& pool) {
+    const bool cipher = config.mode == PipelineMode::CIPHER;
+    const CompiledPipeline inverse = cipher ? compile_inverse_pipeline(config) : pipeline;
+    VerificationReport report = collect_mismatches(65536, pool, [&](size_t begin, size_t end, vector<Mismatch>& found) {
+        vector<uint16_t> inputs(end - begin), outputs(end - begin), decrypted(end - begin), sliced(end - begin);
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            inputs[i] = static_cast<uint16_t>(begin + i);
+        }
+        snake_transformation_pipeline_batch(pipeline, inputs, outputs, begin, stream);
+        if (cipher) {
+            snake_transformation_pipeline_batch(inverse, outputs, decrypted, begin, stream);
+        }
+        pipeline.pre_quantum.bitsliced.apply(inputs.data(), sliced.data(), inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            uint16_t expected = reference_pipeline(config, inputs[i], begin + i, stream);
+            if (outputs[i] != expected) {
+                found.push_back({ 0, begin + i, inputs[i], expected, outputs[i], "batch vs reference" });
+            }
+            if (sliced[i] != pipeline.pre_quantum.table[inputs[i]]) {
+                found.push_back({ 0, begin + i, inputs[i], pipeline.pre_quantum.table[inputs[i]], sliced[i], "bitsliced vs table" });
+            }
+            if (cipher && decrypted[i] != inputs[i]) {
+                found.push_back({ 0, begin + i, outputs[i], inputs[i], decrypted[i], "inverse" });
+            }
+        }
+    });
+    report.checked = cipher ? 3 * 65536 : 2 * 65536;
+    return report;
+}
+
+j. Benchmark Suite
+
+--bench times every stage (and gf_multiply, whether or not the pipeline uses it) on its own and the pipeline as a whole, so regressions show up as numbers rather than impressions. Each stage comes in up to four variants: scalar (the word-at-a-time code above), table (the folded map read from its lookup table), batch (the vector kernels) and bitsliced (the bit-plane kernels). Every variant runs over buffers from L1-resident to as large as --bench-max allows, on one thread and on the whole pool. A run is calibrated so that each sample lasts at least a couple of milliseconds, warmed up, repeated, and reported as the mean, standard deviation and best ns per word together with GB/s at the mean, in CSV or JSON.
+
+// One timed case. 'run' transforms 'bytes' bytes (a multiple of 8) from 'in' to 'out',
+// where in[0] is byte 'first_byte' of the stream being transformed.
+struct BenchmarkCase {
+    string name;        // Stage, e.g. "rotate_left" or "Transformer2"
+    string variant;     // scalar, table, batch or bitsliced
+    size_t word_bytes;  // Width of the words the case transforms
+    function<void(const uint8_t* in, uint8_t* out, size_t bytes, uint64_t first_byte)> run;
+};
+
+struct BenchmarkOptions {
+    size_t max_bytes = size_t{ 64 } << 20;    // Largest buffer; sizes grow 64x from 4 KiB up to it
+    unsigned warmup = 1;
+    unsigned repetitions = 5;
+    string filter;                            // Only cases whose "name/variant" contains this
+    bool json = false;
+};
+
+struct BenchmarkResult {
+    string name;
+    string variant;
+    size_t bytes;
+    unsigned threads;
+    unsigned repetitions;
+    double mean_ns_per_word;
+    double stddev_ns_per_word;
+    double min_ns_per_word;
+    double gb_per_s;
+};
+
+// Adapt a loop over 16-bit words to the byte interface. Buffers come from aligned_alloc,
+// so every case may treat them as an array of its own word type.
+template <PipelineWord Word, typename Body>
+BenchmarkCase word_case(string name, string variant, Body body) {
+    return { name, variant, sizeof(Word), [body](const uint8_t* in, uint8_t* out, size_t bytes, uint64_t first_byte) {
+        body(reinterpret_cast<const Word*>(in), reinterpret_cast<Word*>(out), bytes / sizeof(Word), first_byte / sizeof(Word));
+    } };
+}
+
+// Every stage of the active pipeline in every variant it has
+vector<BenchmarkCase> benchmark_cases() {
+    const PipelineConfig& config = active_pipeline();
+    const CompiledPipeline& pipeline = active_compiled_pipeline();
+    const QuantumKey key{ config.seed, SNAKE_B_STREAM };
+    const PipelineMode mode = config.mode;
+    vector<BenchmarkCase> cases;
+
+    cases.push_back(word_case<uint16_t>("rotate_left", "scalar", [](const uint16_t* in, uint16_t* out, size_t n, uint64_t) {
+        for (size_t i = 0; i < n; ++i) out[i] = rotate_left(in[i], 3);
+    }));
+    cases.push_back(word_case<uint16_t>("xor_with_key", "scalar", [](const uint16_t* in, uint16_t* out, size_t n, uint64_t) {
+        for (size_t i = 0; i < n; ++i) out[i] = xor_with_key(in[i], KEY_333);
+    }));
+    cases.push_back(word_case<uint16_t>("invert_bits", "scalar", [](const uint16_t* in, uint16_t* out, size_t n, uint64_t) {
+        for (size_t i = 0; i < n; ++i) out[i] = invert_bits(in[i]);
+    }));
+    cases.push_back(word_case<uint16_t>("reflect", "scalar", [](const uint16_t* in, uint16_t* out, size_t n, uint64_t) {
+        for (size_t i = 0; i < n; ++i) out[i] = reflect(in[i], REFLECTOR_FFF);
+    }));
+
+    // A deterministic stage four ways: interpreted, through its table, through its kernel and through bit-planes
+    auto add_affine_stage = [&cases](const string& name, function<uint16_t(uint16_t)> scalar, const AffineMap16& map) {
+        cases.push_back(word_case<uint16_t>(name, "scalar", [scalar](const uint16_t* in, uint16_t* out, size_t n, uint64_t) {
+            for (size_t i = 0; i < n; ++i) out[i] = scalar(in[i]);
+        }));
+        const uint16_t* table = affine_lookup_table(map).data();
+        cases.push_back(word_case<uint16_t>(name, "table", [table](const uint16_t* in, uint16_t* out, size_t n, uint64_t) {
+            for (size_t i = 0; i < n; ++i) out[i] = table[in[i]];
+        }));
+        const AffineKernel kernel = AffineKernel::build(map);
+        cases.push_back(word_case<uint16_t>(name, "batch", [kernel](const uint16_t* in, uint16_t* out, size_t n, uint64_t) {
+            kernel.apply(in, out, n);
+        }));
+        cases.push_back(word_case<uint16_t>(name, "bitsliced", [kernel](const uint16_t* in, uint16_t* out, size_t n, uint64_t) {
+            kernel.bitsliced.apply(in, out, n);
+        }));
+    };
+    const Op multiply = Op::gf_multiply(0xBEEF);
+    add_affine_stage("gf_multiply", [multiply](uint16_t word) { return execute(multiply, word); }, compile_op(multiply));
+    for (const auto& transformer : config.transformers) {
+        add_affine_stage(transformer.name, [transformer](uint16_t word) { return transformer.apply<TraceLevel::Silent>(word); },
+                         compile_transformer(transformer));
+    }
+    const vector<CrownedPrime> crowned_primes = config.crowned_primes;
+    add_affine_stage("apply_crowned_primes",
+                     [crowned_primes](uint16_t word) { return apply_crowned_primes<TraceLevel::Silent>(word, crowned_primes); },
+                     compile_crowned_primes(crowned_primes));
+
+    cases.push_back(word_case<uint16_t>("quantum_inspired_transform", "scalar",
+                                        [key, mode](const uint16_t* in, uint16_t* out, size_t n, uint64_t first) {
+        for (size_t i = 0; i < n; ++i) out[i] = quantum_inspired_transform<TraceLevel::Silent>(in[i], key, first + i, mode);
+    }));
+    cases.push_back(word_case<uint16_t>("quantum_inspired_transform", "batch",
+                                        [key, mode](const uint16_t* in, uint16_t* out, size_t n, uint64_t first) {
+        if (mode == PipelineMode::CIPHER) {
+            memcpy(out, in, n * sizeof(uint16_t));
+            quantum_keystream_xor_batch(out, n, key, first);
+        } else {
+            quantum_measure_batch(out, n, key, first);
+        }
+    }));
+
+    cases.push_back(word_case<uint16_t>("pipeline", "scalar", [](const uint16_t* in, uint16_t* out, size_t n, uint64_t first) {
+        for (size_t i = 0; i < n; ++i) out[i] = snake_transformation_pipeline<TraceLevel::Silent>(in[i], first + i, SNAKE_B_STREAM);
+    }));
+    cases.push_back(word_case<uint16_t>("pipeline", "table", [&pipeline](const uint16_t* in, uint16_t* out, size_t n, uint64_t first) {
+        for (size_t i = 0; i < n; ++i) out[i] = pipeline.run(in[i], first + i, SNAKE_B_STREAM);
+    }));
+    cases.push_back(word_case<uint16_t>("pipeline", "batch", [&pipeline](const uint16_t* in, uint16_t* out, size_t n, uint64_t first) {
+        snake_transformation_pipeline_batch(pipeline, span<const uint16_t>(in, n), span<uint16_t>(out, n), first, SNAKE_B_STREAM);
+    }));
+
+    // The same pipeline on wider words: the same bytes in fewer, wider operations
+    auto add_wide_pipeline = [&cases]<PipelineWord Word>(const string& name) {
+        const CompiledWidePipeline<Word>& wide = active_compiled_wide_pipeline<Word>();
+        cases.push_back(word_case<Word>(name, "batch", [&wide](const Word* in, Word* out, size_t n, uint64_t first) {
+            snake_transformation_pipeline_batch(wide, span<const Word>(in, n), span<Word>(out, n), first, SNAKE_B_STREAM);
+        }));
+    };
+    add_wide_pipeline.template operator()<uint32_t>("pipeline32");
+    add_wide_pipeline.template operator()<uint64_t>("pipeline64");
+    add_wide_pipeline.template operator()<uint128_t>("pipeline128");
+    return cases;
+}
+
+// Time one case over 'bytes' bytes of 'in' on one thread, or split across the pool
+BenchmarkResult time_benchmark_case(const BenchmarkCase& bench, const uint8_t* in, uint8_t* out, size_t bytes,
+                                    bool use_pool, WorkStealingPool& pool, const BenchmarkOptions& options) {
+    using clock = chrono::steady_clock;
+    auto pass = [&] {
+        if (!use_pool) {
+            bench.run(in, out, bytes, 0);
+            return;
+        }
+        // Split at whole words of the case, 32 KiB at a time, so every range stays aligned to its word type
+        const size_t word_bytes = bench.word_bytes;
+        pool.parallel_for(bytes / word_bytes, (size_t{ 32 } << 10) / word_bytes, [&](size_t begin, size_t end) {
+            bench.run(in + word_bytes * begin, out + word_bytes * begin, word_bytes * (end - begin), word_bytes * begin);
+        });
+    };
+    auto seconds_for = [&](size_t passes) {
+        auto start = clock::now();
+        for (size_t p = 0; p < passes; ++p) {
+            pass();
+        }
+        return chrono::duration<double>(clock::now() - start).count();
+    };
+
+    // Enough passes per sample that small buffers are not timed at clock resolution
+    const double single = max(seconds_for(1), 1e-9);
+    const size_t passes = max<size_t>(1, min<size_t>(1 << 20, static_cast<size_t>(2e-3 / single)));
+    for (unsigned w = 0; w < options.warmup; ++w) {
+        seconds_for(passes);
+    }
+    const double words = static_cast<double>(bytes / bench.word_bytes) * passes;
+    vector<double> samples;
+    for (unsigned r = 0; r < options.repetitions; ++r) {
+        samples.push_back(seconds_for(passes) * 1e9 / words);
+    }
+
+    double mean = 0;
+    for (double sample : samples) mean += sample;
+    mean /= samples.size();
+    double variance = 0;
+    for (double sample : samples) variance += (sample - mean) * (sample - mean);
+    variance /= samples.size() > 1 ? samples.size() - 1 : 1;
+
+    BenchmarkResult result;
+    result.name = bench.name;
+    result.variant = bench.variant;
+    result.bytes = bytes;
+    result.threads = use_pool ? pool.size() : 1;
+    result.repetitions = options.repetitions;
+    result.mean_ns_per_word = mean;
+    result.stddev_ns_per_word = sqrt(variance);
+    result.min_ns_per_word = *min_element(samples.begin(), samples.end());
+    result.gb_per_s = bench.word_bytes / mean;    // bytes per ns
+    return result;
+}
+
+void print_benchmark_results(ostream& out, const vector<BenchmarkResult>& results, bool json) {
+    static const char* const SIMD_NAMES[] = { "scalar", "sse2", "avx2", "avx512" };
+    const char* simd = SIMD_NAMES[static_cast<int>(simd_level())];
+    char line[256];
+    if (!json) {
+        out << "name,variant,bytes,threads,repetitions,mean_ns_per_word,stddev_ns_per_word,min_ns_per_word,gb_per_s,simd\n";
+        for (const auto& r : results) {
+            snprintf(line, sizeof(line), "%s,%s,%zu,%u,%u,%.4f,%.4f,%.4f,%.3f,%s\n", r.name.c_str(), r.variant.c_str(),
+                     r.bytes, r.threads, r.repetitions, r.mean_ns_per_word, r.stddev_ns_per_word, r.min_ns_per_word,
+                     r.gb_per_s, simd);
+            out << line;
+        }
+        return;
+    }
+    out << "{\"simd\": \"" << simd << "\", \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        snprintf(line, sizeof(line),
+                 "  {\"name\": \"%s\", \"variant\": \"%s\", \"bytes\": %zu, \"threads\": %u, \"repetitions\": %u, "
+                 "\"mean_ns_per_word\": %.4f, \"stddev_ns_per_word\": %.4f, \"min_ns_per_word\": %.4f, \"gb_per_s\": %.3f}",
+                 r.name.c_str(), r.variant.c_str(), r.bytes, r.threads, r.repetitions, r.mean_ns_per_word,
+                 r.stddev_ns_per_word, r.min_ns_per_word, r.gb_per_s);
+        out << line << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]}\n";
+}
+
+// Run every matching case at every size, single-threaded and on the pool
+vector<BenchmarkResult> run_benchmarks(const BenchmarkOptions& options, WorkStealingPool& pool) {
+    vector<size_t> sizes;
+    for (size_t bytes = 4096; bytes < options.max_bytes; bytes *= 64) {
+        sizes.push_back(bytes);
+    }
+    sizes.push_back(max<size_t>(options.max_bytes & ~size_t{ 63 }, 64));
+
+    // Random input, filled on the pool so multi-GB runs do not start with a serial pass
+    const size_t largest = sizes.back();
+    unique_ptr<uint8_t, decltype(&free)> in(static_cast<uint8_t*>(aligned_alloc(64, largest)), &free);
+    unique_ptr<uint8_t, decltype(&free)> out(static_cast<uint8_t*>(aligned_alloc(64, largest)), &free);
+    if (!in || !out) {
+        throw runtime_error("--bench: cannot allocate " + to_string(largest) + " bytes");
+    }
+    pool.parallel_for(largest / 8, 1 << 16, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            uint64_t bits = splitmix64(i);
+            memcpy(in.get() + 8 * i, &bits, 8);
+        }
+        memset(out.get() + 8 * begin, 0, 8 * (end - begin));
+    });
+
+    vector<BenchmarkResult> results;
+    for (const BenchmarkCase& bench : benchmark_cases()) {
+        if ((bench.name + "/" + bench.variant).find(options.filter) == string::npos) {
+            continue;
+        }
+        for (size_t bytes : sizes) {
+            results.push_back(time_benchmark_case(bench, in.get(), out.get(), bytes, false, pool, options));
+            if (pool.size() > 1) {
+                results.push_back(time_benchmark_case(bench, in.get(), out.get(), bytes, true, pool, options));
+            }
+        }
+    }
+    return results;
+}
+
+// A byte count with an optional K, M or G suffix (powers of 1024)
+size_t parse_byte_count(const string& text, const string& source) {
+    size_t used = 0;
+    unsigned long long value = 0;
+    try {
+        value = stoull(text, &used, 10);
+    } catch (const exception&) {
+        used = 0;
+    }
+    const string suffix = used > 0 ? text.substr(used) : "";
+    const int shift = suffix.empty() ? 0 : suffix == "K" ? 10 : suffix == "M" ? 20 : suffix == "G" ? 30 : -1;
+    if (used == 0 || shift < 0 || value == 0 || value > (~0ULL >> shift)) {
+        throw invalid_argument(source + ": expected a byte count such as 65536, 512K, 64M or 4G, got '" + text + "'");
+    }
+    return static_cast<size_t>(value << shift);
+}
+
+k. Bit Pattern Images
+
+visualize_bit_pattern draws one word as text, which is fine for the demo and useless for a million words. --image draws them all at once: every little-endian word of a file is transformed as --encrypt-file would transform it and becomes a 4x4 tile of one binary PGM or PPM image, tiles running left to right and then top to bottom, with bit i of a word at row i/4, column i%4 of its tile just as visualize_bit_pattern places it. There are three colorings:
+
+gray      PGM; set bits white, clear bits black
+color     PPM; each bit classified by Color against the word before the pipeline: RED cleared, GREEN set, BLUE set in both, black clear in both
+bitstate  PPM; each horizontal pair of bits classified by BitState, both pixels painted its color
+
+The image file is sized up front, mapped, and filled by the pool one band of tile rows per task. A task transforms its band into two buffers of its own and then writes each pixel row of the band as a run of table lookups, one per 4-bit row of a tile, so no word costs an allocation or a branch. An odd trailing byte is not drawn.
+
+enum class ImageColoring {
+    GRAY,
+    COLOR,
+    BIT_STATE
+};
+
+ImageColoring parse_image_coloring(const string& name) {
+    if (name == "gray") return ImageColoring::GRAY;
+    if (name == "color") return ImageColoring::COLOR;
+    if (name == "bitstate") return ImageColoring::BIT_STATE;
+    throw invalid_argument("--coloring: expected gray, color or bitstate, got '" + name + "'");
+}
+
+using Rgb = array<uint8_t, 3>;
+
+Rgb color_rgb(Color color) {
+    switch (color) {
+        case Color::RED: return { 255, 48, 48 };
+        case Color::GREEN: return { 48, 255, 48 };
+        case Color::BLUE: return { 64, 96, 255 };
+    }
+    return { 0, 0, 0 };
+}
+
+Rgb bit_state_rgb(BitState state) {
+    switch (state) {
+        case BitState::ZERO_ZERO: return { 0, 0, 0 };
+        case BitState::ZERO_ONE: return { 255, 160, 0 };
+        case BitState::ONE_ZERO: return { 0, 160, 255 };
+        case BitState::ONE_ONE: return { 255, 255, 255 };
+    }
+    return { 0, 0, 0 };
+}
+
+// The pixels of one 4-bit row of a tile, for every row value (and, in COLOR, every
+// value of the same row before the pipeline): 4 or 12 bytes per entry
+struct TileRowPalette {
+    size_t channels;                        // 1 for PGM, 3 for PPM
+    vector<uint8_t> pixels;                 // Indexed by (before << 4 | after) * 4 * channels
+
+    static TileRowPalette build(ImageColoring coloring) {
+        TileRowPalette palette;
+        palette.channels = coloring == ImageColoring::GRAY ? 1 : 3;
+        palette.pixels.resize(256 * 4 * palette.channels);
+        for (unsigned before = 0; before < 16; ++before) {
+            for (unsigned after = 0; after < 16; ++after) {
+                uint8_t* entry = palette.pixels.data() + (before << 4 | after) * 4 * palette.channels;
+                for (unsigned column = 0; column < 4; ++column) {
+                    const bool was_set = (before >> column) & 1;
+                    const bool is_set = (after >> column) & 1;
+                    if (coloring == ImageColoring::GRAY) {
+                        entry[column] = is_set ? 255 : 0;
+                        continue;
+                    }
+                    Rgb rgb = { 0, 0, 0 };
+                    if (coloring == ImageColoring::COLOR) {
+                        if (was_set || is_set) {
+                            rgb = color_rgb(was_set && is_set ? Color::BLUE : is_set ? Color::GREEN : Color::RED);
+                        }
+                    } else {
+                        const unsigned pair = column & ~1u;
+                        const bool left = (after >> pair) & 1;
+                        const bool right = (after >> (pair + 1)) & 1;
+                        rgb = bit_state_rgb(left ? (right ? BitState::ONE_ONE : BitState::ONE_ZERO)
+                                                 : (right ? BitState::ZERO_ONE : BitState::ZERO_ZERO));
+                    }
+                    memcpy(entry + 3 * column, rgb.data(), 3);
+                }
+            }
+        }
+        return palette;
+    }
+
+    const uint8_t* row(unsigned before, unsigned after) const { return pixels.data() + (before << 4 | after) * 4 * channels; }
+};
+
+struct ImageStats {
+    uint64_t words = 0;
+    uint64_t width = 0;     // Pixels
+    uint64_t height = 0;
+};
+
+// Draw the words of 'input_path', transformed by 'pipeline' on 'stream', into 'output_path'
+// with 'tiles_per_row' tiles across (0 picks up to 256)
+ImageStats render_bit_image(const string& input_path, const string& output_path, ImageColoring coloring, size_t tiles_per_row,
+                            const CompiledPipeline& pipeline, uint64_t stream, WorkStealingPool& pool) {
+    UniqueFd input(open(input_path.c_str(), O_RDONLY));
+    struct stat input_stat;
+    if (input.get() < 0 || fstat(input.get(), &input_stat) != 0) {
+        throw system_error_for(input_path);
+    }
+    const size_t words = static_cast<size_t>(input_stat.st_size) / 2;
+    if (words == 0) {
+        throw runtime_error(input_path + ": no words to draw");
+    }
+    MappedFile source(input.get(), static_cast<size_t>(input_stat.st_size), false, input_path);
+
+    const size_t tiles = tiles_per_row == 0 ? min<size_t>(words, 256) : tiles_per_row;
+    const size_t tile_rows = (words + tiles - 1) / tiles;
+    const TileRowPalette palette = TileRowPalette::build(coloring);
+    const size_t row_bytes = 4 * tiles * palette.channels;
+    char header[64];
+    const int header_size = snprintf(header, sizeof(header), "%s\n%zu %zu\n255\n", palette.channels == 1 ? "P5" : "P6", 4 * tiles,
+                                     4 * tile_rows);
+    const size_t image_size = header_size + 4 * tile_rows * row_bytes;
+
+    UniqueFd output(open(output_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644));
+    if (output.get() < 0 || ftruncate(output.get(), static_cast<off_t>(image_size)) != 0) {
+        throw system_error_for(output_path);
+    }
+    MappedFile target(output.get(), image_size, true, output_path);
+    memcpy(target.data(), header, header_size);
+    const uint8_t* in = source.data();
+    uint8_t* pixels = target.data() + header_size;
+
+    pool.parallel_for(tile_rows, max<size_t>(1, 4096 / tiles), [&](size_t begin, size_t end) {
+        const size_t first = begin * tiles;
+        const size_t count = min(end * tiles, words) - first;
+        vector<uint16_t> before(count), after(count);
+        for (size_t i = 0; i < count; ++i) {
+            before[i] = static_cast<uint16_t>(in[2 * (first + i)] | in[2 * (first + i) + 1] << 8);
+        }
+        snake_transformation_pipeline_batch(pipeline, before, after, first, stream);
+
+        const size_t pixel_bytes = 4 * palette.channels;
+        for (size_t tile_row = begin; tile_row < end; ++tile_row) {
+            const size_t row_first = (tile_row - begin) * tiles;
+            const size_t row_count = min(tiles, count - row_first);
+            for (unsigned bit_row = 0; bit_row < 4; ++bit_row) {
+                uint8_t* out = pixels + (4 * tile_row + bit_row) * row_bytes;
+                for (size_t t = 0; t < row_count; ++t) {
+                    const unsigned was = (before[row_first + t] >> (4 * bit_row)) & 0xF;
+                    const unsigned now = (after[row_first + t] >> (4 * bit_row)) & 0xF;
+                    memcpy(out + t * pixel_bytes, palette.row(was, now), pixel_bytes);
+                }
+                // Past the last word the tiles stay black
+                memset(out + row_count * pixel_bytes, 0, (tiles - row_count) * pixel_bytes);
+            }
+        }
+    });
+
+    ImageStats stats;
+    stats.words = words;
+    stats.width = 4 * tiles;
+    stats.height = 4 * tile_rows;
+    return stats;
+}
+
+l. Emirp Sieve: Crowned Primes at Scale
+
+An emirp is a prime whose decimal digits, reversed, spell a different prime: 13 and 31, 107 and 701. The emirps up to a limit come from a sieve of Eratosthenes that stores only odd numbers, one bit each, and works through the bit array in segments small enough to stay in cache, one segment per task on the pool. A second parallel pass keeps each prime whose reversal is also prime and not the prime itself, looking the reversal up in the same bits when it is within the limit and testing it with a deterministic Miller-Rabin test when it is not (9-digit primes reverse into range, 10-digit ones may not).
+
+Sieving to 10^9 takes seconds; a crown of weights is wanted at startup. So the emirps found are kept in a binary cache file, $ONEGOD_EMIRP_CACHE or onegod/emirps under the user's cache directory ($XDG_CACHE_HOME, else ~/.cache), as the sieve limit followed by the gaps between successive emirps, halved and written as variable-length integers (most take one byte). A later run that needs emirps up to the same limit or a smaller one decodes the cache instead of sieving; a larger limit sieves again and replaces it.
+
+emirp_crowned_primes then builds crowns of weights from the list: the requested number of emirps spread evenly over it, each weighted by the low 16 bits of its reversal. However many crowns there are, the compiled pipelines fold them into one constant, so a large crown costs nothing per word outside the interpreted path.
+
+// Numbers per sieve segment: 8 odd numbers per byte, so 2 MiB of numbers per 128 KiB segment
+constexpr size_t SIEVE_SEGMENT_BYTES = 128 << 10;
+
+// Primality of the odd numbers up to 'limit': bit i of 'bits' stands for 2i + 1
+struct OddPrimeBits {
+    uint64_t limit = 0;
+    vector<uint64_t> bits;
+
+    bool is_prime(uint64_t n) const {
+        if (n < 3 || n % 2 == 0) {
+            return n == 2;
+        }
+        return (bits[n / 128] >> (n / 2 % 64)) & 1;
+    }
+};
+
+// Odd primes up to 'limit' by plain sieve; used for the base primes up to sqrt(limit)
+vector<uint32_t> small_odd_primes(uint32_t limit) {
+    vector<bool> composite(limit + 1);
+    vector<uint32_t> primes;
+    for (uint32_t n = 3; n <= limit; n += 2) {
+        if (composite[n]) {
+            continue;
+        }
+        primes.push_back(n);
+        for (uint64_t multiple = uint64_t{ n } * n; multiple <= limit; multiple += 2 * n) {
+            composite[multiple] = true;
+        }
+    }
+    return primes;
+}
+
+OddPrimeBits sieve_odd_primes(uint32_t limit, WorkStealingPool& pool) {
+    OddPrimeBits sieve;
+    sieve.limit = limit;
+    const uint64_t total_bits = (uint64_t{ limit } + 1) / 2;          // 1, 3, 5, ... up to limit
+    sieve.bits.assign((total_bits + 63) / 64, ~uint64_t{ 0 });
+    const vector<uint32_t> base = small_odd_primes(static_cast<uint32_t>(sqrt(static_cast<double>(limit))) + 1);
+
+    constexpr uint64_t segment_bits = SIEVE_SEGMENT_BYTES * 8;
+    const size_t segments = (total_bits + segment_bits - 1) / segment_bits;
+    pool.parallel_for(segments, 1, [&](size_t begin, size_t end) {
+        for (size_t segment = begin; segment < end; ++segment) {
+            const uint64_t first = segment * segment_bits;
+            const uint64_t last = min(first + segment_bits, total_bits);   // Bit indexes [first, last)
+            uint64_t* words = sieve.bits.data();
+            for (uint32_t p : base) {
+                // The first odd multiple of p at or above max(p^2, 2 * first + 1), as a bit index
+                uint64_t start = max(uint64_t{ p } * p, 2 * first + 1);
+                start = (start + p - 1) / p * p;
+                start += start % 2 == 0 ? p : 0;
+                for (uint64_t bit = start / 2; bit < last; bit += p) {
+                    words[bit / 64] &= ~(uint64_t{ 1 } << (bit % 64));
+                }
+            }
+        }
+    });
+    sieve.bits[0] &= ~uint64_t{ 1 };    // 1 is not prime
+    if (total_bits % 64 != 0) {
+        sieve.bits.back() &= (uint64_t{ 1 } << (total_bits % 64)) - 1;
+    }
+    return sieve;
+}
+
+uint64_t reverse_digits(uint64_t n) {
+    uint64_t reversed = 0;
+    for (; n > 0; n /= 10) {
+        reversed = reversed * 10 + n % 10;
+    }
+    return reversed;
+}
+
+// Deterministic Miller-Rabin for n < 3,474,749,660,383, which covers every reversed 10-digit number
+bool is_prime_miller_rabin(uint64_t n) {
+    if (n < 2) {
+        return false;
+    }
+    for (uint64_t p : { 2, 3, 5, 7, 11, 13 }) {
+        if (n % p == 0) {
+            return n == p;
+        }
+    }
+    auto multiply = [n](uint64_t a, uint64_t b) { return static_cast<uint64_t>(static_cast<uint128_t>(a) * b % n); };
+    const int shift = countr_zero(n - 1);
+    const uint64_t odd = (n - 1) >> shift;
+    for (uint64_t a : { 2, 3, 5, 7, 11, 13 }) {
+        uint64_t x = 1;
+        for (uint64_t power = a, e = odd; e > 0; e >>= 1, power = multiply(power, power)) {
+            x = e & 1 ? multiply(x, power) : x;
+        }
+        if (x == 1 || x == n - 1) {
+            continue;
+        }
+        bool witness = true;
+        for (int i = 1; i < shift && witness; ++i) {
+            x = multiply(x, x);
+            witness = x != n - 1;
+        }
+        if (witness) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// All emirps up to 'limit', in increasing order
+vector<uint32_t> sieve_emirps(uint32_t limit, WorkStealingPool& pool) {
+    const OddPrimeBits sieve = sieve_odd_primes(limit, pool);
+    constexpr size_t words_per_task = SIEVE_SEGMENT_BYTES / 8;
+    const size_t tasks = (sieve.bits.size() + words_per_task - 1) / words_per_task;
+    vector<vector<uint32_t>> found(tasks);
+    pool.parallel_for(tasks, 1, [&](size_t begin, size_t end) {
+        for (size_t task = begin; task < end; ++task) {
+            const size_t last = min((task + 1) * words_per_task, sieve.bits.size());
+            for (size_t w = task * words_per_task; w < last; ++w) {
+                for (uint64_t word = sieve.bits[w]; word != 0; word &= word - 1) {
+                    const uint64_t prime = 2 * (64 * w + countr_zero(word)) + 1;
+                    const uint64_t reversed = reverse_digits(prime);
+                    // The reversal ends in the prime's leading digit, which rules out most at once
+                    if (reversed == prime || reversed % 2 == 0 || reversed % 5 == 0) {
+                        continue;
+                    }
+                    if (reversed <= limit ? sieve.is_prime(reversed) : is_prime_miller_rabin(reversed)) {
+                        found[task].push_back(static_cast<uint32_t>(prime));
+                    }
+                }
+            }
+        }
+    });
+
+    vector<uint32_t> emirps;
+    for (const auto& chunk : found) {
+        emirps.insert(emirps.end(), chunk.begin(), chunk.end());
+    }
+    return emirps;
+}
+
+// $ONEGOD_EMIRP_CACHE, else onegod/emirps in the XDG cache directory ($XDG_CACHE_HOME, or ~/.cache).
+// Empty when there is nowhere to put it, and then nothing is cached.
+string emirp_cache_path() {
+    if (const char* path = getenv("ONEGOD_EMIRP_CACHE")) {
+        return path;
+    }
+    if (const char* cache = getenv("XDG_CACHE_HOME"); cache && cache[0] == '/') {
+        return string(cache) + "/onegod/emirps";
+    }
+    if (const char* home = getenv("HOME"); home && home[0] != '\0') {
+        return string(home) + "/.cache/onegod/emirps";
+    }
+    return "";
+}
+
+// Create every missing directory above 'path'
+void make_parent_directories(const string& path) {
+    for (size_t slash = path.find('/', 1); slash != string::npos; slash = path.find('/', slash + 1)) {
+        const string directory = path.substr(0, slash);
+        if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+            throw system_error_for(directory);
+        }
+    }
+}
+
+// Cache layout: "OGEMIRP1", then the limit and the emirp count as little-endian 64-bit
+// integers, then each emirp as (emirp - previous) / 2 in LEB128, starting from previous = 1
+constexpr char EMIRP_CACHE_MAGIC[8] = { 'O', 'G', 'E', 'M', 'I', 'R', 'P', '1' };
+
+void save_emirp_cache(const string& path, uint32_t limit, const vector<uint32_t>& emirps) {
+    string data(EMIRP_CACHE_MAGIC, sizeof(EMIRP_CACHE_MAGIC));
+    for (uint64_t field : { uint64_t{ limit }, uint64_t{ emirps.size() } }) {
+        for (int byte = 0; byte < 8; ++byte) {
+            data += static_cast<char>(field >> (8 * byte));
+        }
+    }
+    uint32_t previous = 1;
+    for (uint32_t emirp : emirps) {
+        for (uint32_t gap = (emirp - previous) / 2;; gap >>= 7) {
+            data += static_cast<char>((gap & 0x7F) | (gap > 0x7F ? 0x80 : 0));
+            if (gap <= 0x7F) {
+                break;
+            }
+        }
+        previous = emirp;
+    }
+
+    // Written beside the cache and renamed over it, so readers never see half a file
+    make_parent_directories(path);
+    const string temporary = path + ".tmp";
+    UniqueFd out(open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+    if (out.get() < 0) {
+        throw system_error_for(temporary);
+    }
+    write_fully(out.get(), data.data(), data.size(), temporary);
+    if (rename(temporary.c_str(), path.c_str()) != 0) {
+        throw system_error_for(path);
+    }
+}
+
+// The cached emirps up to 'limit', if the cache exists, is intact and reaches that far
+bool load_emirp_cache(const string& path, uint32_t limit, vector<uint32_t>& emirps) {
+    UniqueFd fd(open(path.c_str(), O_RDONLY));
+    struct stat info;
+    if (fd.get() < 0 || fstat(fd.get(), &info) != 0 || static_cast<size_t>(info.st_size) < 24) {
+        return false;
+    }
+    MappedFile file(fd.get(), static_cast<size_t>(info.st_size), false, path);
+    const uint8_t* data = file.data();
+    auto field = [data](size_t offset) {
+        uint64_t value = 0;
+        for (int byte = 7; byte >= 0; --byte) {
+            value = value << 8 | data[offset + byte];
+        }
+        return value;
+    };
+    const uint64_t cached_limit = field(8);
+    const uint64_t count = field(16);
+    if (memcmp(data, EMIRP_CACHE_MAGIC, sizeof(EMIRP_CACHE_MAGIC)) != 0 || cached_limit < limit || count > file.size()) {
+        return false;
+    }
+
+    emirps.clear();
+    emirps.reserve(count);
+    uint64_t previous = 1;
+    for (size_t offset = 24; emirps.size() < count;) {
+        uint64_t gap = 0;
+        for (int shift = 0;; shift += 7) {
+            if (offset >= file.size() || shift > 28) {
+                return false;
+            }
+            const uint8_t byte = data[offset++];
+            gap |= uint64_t{ byte & 0x7Fu } << shift;
+            if (byte < 0x80) {
+                break;
+            }
+        }
+        previous += 2 * gap;
+        if (previous > limit) {
+            break;
+        }
+        emirps.push_back(static_cast<uint32_t>(previous));
+    }
+    return true;
+}
+
+// Emirps up to 'limit' from the cache, or from the sieve (then cached)
+vector<uint32_t> emirps_up_to(uint32_t limit, WorkStealingPool& pool) {
+    const string path = emirp_cache_path();
+    vector<uint32_t> emirps;
+    if (!path.empty() && load_emirp_cache(path, limit, emirps)) {
+        return emirps;
+    }
+    emirps = sieve_emirps(limit, pool);
+    if (path.empty()) {
+        return emirps;
+    }
+    try {
+        save_emirp_cache(path, limit, emirps);
+    } catch (const exception& e) {
+        // Not fatal: the next run sieves again
+        cerr << "Warning: emirp cache not written: " << e.what() << endl;
+    }
+    return emirps;
+}
+
+vector<CrownedPrime> emirp_crowned_primes(size_t count, uint32_t limit) {
+    const vector<uint32_t> emirps = emirps_up_to(limit, worker_pool());
+    if (count == 0 || count > emirps.size()) {
+        throw invalid_argument("emirp crowns: asked for " + to_string(count) + " of the " + to_string(emirps.size())
+                               + " emirps up to " + to_string(limit));
+    }
+    vector<CrownedPrime> crowned_primes;
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t emirp = emirps[i * emirps.size() / count];
+        crowned_primes.emplace_back(emirp, static_cast<uint16_t>(reverse_digits(emirp)));
+    }
+    return crowned_primes;
+}
+
+m. Result Store: An Append-Only Log of Transformations
+
+Results that must outlive a run go to a result store rather than a database: a file of fixed-width records, each holding the hash of the compiled pipeline that produced it, the seed, stream and index it was measured at, the input and the output. Records are only ever appended. The file is mapped once into a window far larger than it will grow, so growing it is an ftruncate and every record keeps its address; writers reserve a run of records with one atomic add and fill it in parallel, without locks.
+
+Each record carries a checksum of its other fields, and an all-zero record never checks out. Opening a store walks the records from the start and keeps them up to the first one that fails, so a run that died mid-batch, or a machine that lost the last pages written, leaves a store that is a clean prefix of what was appended; the file is trimmed back to the records kept when the store is closed. While walking, the store builds its index: for each of the 65536 inputs, the record numbers holding that input in append order, so a lookup by input is one bucket wherever the store has grown to. Bucket entries for new batches are added under a lock, once per batch.
+
+The file begins with a 64-byte header ("OGSTORE1", the record size, a byte-order mark and the record count at the last sync); records follow in native byte order. An exclusive flock keeps a second process from appending to the same store.
+
+struct StoredResult {
+    uint64_t config_hash;   // CompiledPipeline::config_hash
+    uint64_t seed;
+    uint64_t stream;
+    uint64_t index;
+    uint16_t input;
+    uint16_t output;
+    uint32_t check;         // result_check of the fields above
+};
+
+static_assert(sizeof(StoredResult) == 40, "StoredResult is an on-disk record");
+
+uint32_t result_check(const StoredResult& record) {
+    uint64_t hash = splitmix64(record.config_hash);
+    hash = splitmix64(hash ^ record.seed);
+    hash = splitmix64(hash ^ record.stream);
+    hash = splitmix64(hash ^ record.index);
+    hash = splitmix64(hash ^ (uint64_t{ record.input } << 16 | record.output));
+    const uint32_t check = static_cast<uint32_t>(hash >> 32);
+    return check != 0 ? check : 1;
+}
+
+class ResultStore {
+public:
+    static constexpr char MAGIC[8] = { 'O', 'G', 'S', 'T', 'O', 'R', 'E', '1' };
+    static constexpr size_t HEADER_BYTES = 64;
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static constexpr size_t MAP_BYTES = size_t{ 64 } << 30;     // Address space reserved for the file
+    static constexpr uint64_t MIN_CAPACITY = 1 << 16;           // Records the file is first sized for
+
+    explicit ResultStore(const string& path) : path(path), fd(open(path.c_str(), O_RDWR | O_CREAT, 0644)), index(65536) {
+        struct stat info;
+        if (fd.get() < 0 || fstat(fd.get(), &info) != 0) {
+            throw system_error_for(path);
+        }
+        if (flock(fd.get(), LOCK_EX | LOCK_NB) != 0) {
+            throw runtime_error(path + ": the result store is already open elsewhere");
+        }
+        void* mapped = mmap(nullptr, MAP_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd.get(), 0);
+        if (mapped == MAP_FAILED) {
+            throw system_error_for(path);
+        }
+        base = static_cast<uint8_t*>(mapped);
+        try {
+            open_records(static_cast<uint64_t>(info.st_size));
+        } catch (...) {
+            munmap(base, MAP_BYTES);
+            throw;
+        }
+    }
+
+    ResultStore(const ResultStore&) = delete;
+    ResultStore& operator=(const ResultStore&) = delete;
+
+    ~ResultStore() {
+        try {
+            sync();
+        } catch (const exception&) {
+        }
+        // Trim the spare capacity; if that fails, the next open skips it anyway
+        int trimmed = ftruncate(fd.get(), static_cast<off_t>(HEADER_BYTES + size() * sizeof(StoredResult)));
+        (void)trimmed;
+        munmap(base, MAP_BYTES);
+    }
+
+    uint64_t size() const { return next.load(memory_order_acquire); }
+
+    // Records kept on open beyond the count of the last sync: the tail of an unclean shutdown
+    uint64_t recovered() const { return recovered_records; }
+
+    const StoredResult& operator[](uint64_t record) const { return records()[record]; }
+
+    // Reserve 'count' consecutive records and return the first. The caller fills them
+    // (sealing each with result_check) and then publishes them.
+    uint64_t reserve(size_t count) {
+        const uint64_t first = next.fetch_add(count, memory_order_acq_rel);
+        if (first + count > capacity_now()) {
+            lock_guard<mutex> lock(grow_mutex);
+            if (first + count > capacity) {
+                grow(max(2 * capacity, first + count));
+            }
+        }
+        return first;
+    }
+
+    StoredResult* records() const { return reinterpret_cast<StoredResult*>(base + HEADER_BYTES); }
+
+    // Make filled records [first, first + count) visible to find
+    void publish(uint64_t first, size_t count) {
+        lock_guard<mutex> lock(index_mutex);
+        for (uint64_t record = first; record < first + count; ++record) {
+            index[records()[record].input].push_back(static_cast<uint32_t>(record));
+        }
+    }
+
+    // Append one batch: inputs[i] became outputs[i] as word first_index + i
+    void append(uint64_t config_hash, uint64_t seed, uint64_t stream, uint64_t first_index, span<const uint16_t> inputs,
+                span<const uint16_t> outputs) {
+        const uint64_t first = reserve(inputs.size());
+        StoredResult* out = records() + first;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            out[i] = { config_hash, seed, stream, first_index + i, inputs[i], outputs[i], 0 };
+            out[i].check = result_check(out[i]);
+        }
+        publish(first, inputs.size());
+    }
+
+    // Every record of 'input' produced under 'config_hash', in append order
+    vector<StoredResult> find(uint64_t config_hash, uint16_t input) const {
+        lock_guard<mutex> lock(index_mutex);
+        vector<StoredResult> found;
+        for (uint32_t record : index[input]) {
+            if (records()[record].config_hash == config_hash) {
+                found.push_back(records()[record]);
+            }
+        }
+        return found;
+    }
+
+    // Flush the records to disk, then the header's record count
+    void sync() {
+        const uint64_t count = size();
+        const size_t used = HEADER_BYTES + count * sizeof(StoredResult);
+        if (msync(base, (used + 4095) & ~size_t{ 4095 }, MS_SYNC) != 0) {
+            throw system_error_for(path);
+        }
+        memcpy(base + 16, &count, 8);
+        if (msync(base, 4096, MS_SYNC) != 0) {
+            throw system_error_for(path);
+        }
+    }
+
+private:
+    string path;
+    UniqueFd fd;
+    uint8_t* base = nullptr;
+    uint64_t capacity = 0;                          // Records the file has room for; guarded by grow_mutex
+    atomic<uint64_t> published_capacity{ 0 };
+    atomic<uint64_t> next{ 0 };                     // Records reserved so far
+    uint64_t recovered_records = 0;
+    mutable mutex index_mutex;
+    mutex grow_mutex;
+    vector<vector<uint32_t>> index;                 // By input; record numbers fit in 32 bits within MAP_BYTES
+
+    // Set up a new file, or check an existing one and recover its records
+    void open_records(uint64_t file_size) {
+        if (file_size == 0) {
+            grow(MIN_CAPACITY);
+            memcpy(base, MAGIC, sizeof(MAGIC));
+            const uint32_t record_size = sizeof(StoredResult);
+            memcpy(base + 8, &record_size, 4);
+            memcpy(base + 12, &BYTE_ORDER_MARK, 4);
+        } else {
+            uint32_t record_size = 0;
+            uint32_t byte_order = 0;
+            if (file_size >= HEADER_BYTES) {
+                memcpy(&record_size, base + 8, 4);
+                memcpy(&byte_order, base + 12, 4);
+            }
+            if (file_size < HEADER_BYTES || memcmp(base, MAGIC, sizeof(MAGIC)) != 0 || record_size != sizeof(StoredResult)
+                || byte_order != BYTE_ORDER_MARK) {
+                throw runtime_error(path + ": not a result store (or written on a machine of the other byte order)");
+            }
+            capacity = (file_size - HEADER_BYTES) / sizeof(StoredResult);
+            recover();
+            grow(max(capacity, MIN_CAPACITY));
+        }
+    }
+
+    uint64_t capacity_now() const { return published_capacity.load(memory_order_acquire); }
+
+    void grow(uint64_t records_wanted) {
+        if (HEADER_BYTES + records_wanted * sizeof(StoredResult) > MAP_BYTES) {
+            throw runtime_error(path + ": result store is full");
+        }
+        if (ftruncate(fd.get(), static_cast<off_t>(HEADER_BYTES + records_wanted * sizeof(StoredResult))) != 0) {
+            throw system_error_for(path);
+        }
+        capacity = records_wanted;
+        published_capacity.store(capacity, memory_order_release);
+    }
+
+    // Keep the records up to the first that fails its check, and index them
+    void recover() {
+        uint64_t synced = 0;
+        memcpy(&synced, base + 16, 8);
+        uint64_t kept = 0;
+        const StoredResult* all = records();
+        while (kept < capacity && all[kept].check == result_check(all[kept])) {
+            index[all[kept].input].push_back(static_cast<uint32_t>(kept));
+            ++kept;
+        }
+        next.store(kept, memory_order_release);
+        recovered_records = kept > synced ? kept - synced : 0;
+        // Anything after the first bad record is cleared so a later append cannot revive it
+        memset(const_cast<StoredResult*>(all) + kept, 0, (capacity - kept) * sizeof(StoredResult));
+    }
+};
+
+// Transform 'inputs' as words first_index.. of 'stream' and append every result,
+// the pool filling the records straight from the batch pipeline
+void append_pipeline_results(ResultStore& store, const CompiledPipeline& pipeline, span<const uint16_t> inputs,
+                             uint64_t first_index, uint64_t stream, WorkStealingPool& pool) {
+    const uint64_t first = store.reserve(inputs.size());
+    StoredResult* records = store.records() + first;
+    pool.parallel_for(inputs.size(), 1 << 14, [&](size_t begin, size_t end) {
+        uint16_t outputs[1024];
+        for (size_t block = begin; block < end; block += 1024) {
+            const size_t count = min<size_t>(1024, end - block);
+            snake_transformation_pipeline_batch(pipeline, inputs.subspan(block, count), span<uint16_t>(outputs, count),
+                                                first_index + block, stream);
+            for (size_t i = 0; i < count; ++i) {
+                StoredResult& record = records[block + i];
+                record = { pipeline.config_hash, pipeline.seed, stream, first_index + block + i, inputs[block + i], outputs[i], 0 };
+                record.check = result_check(record);
+            }
+        }
+    });
+    store.publish(first, inputs.size());
+}
+
+n. Cycle Analysis: The Pipeline as a Permutation
+
+Leave out the quantum stage and what remains of the pipeline (transformers, crowns of weights, final reflection) maps words to words one to one: a permutation. Its cycles say how good a key and transformer choice is. A fixed point goes through the pipeline unchanged, and a word on a short cycle comes back to itself after a few passes. --cycles reports the cycle structure: the number of cycles, the fixed points and a histogram of cycle lengths; --orbit lists the cycle through one word.
+
+For 16- and 32-bit words every word is visited, the pool walking cycles from ranges of starting words in parallel. A cycle is counted by its smallest word: a walk that meets a smaller word than the one it started from stops early, since that word's walk will count the cycle. On a short cycle that happens within a few steps, but on a long one a walk could run for millions of steps before it did, so once a long cycle has been counted its words are marked in a bitset (8 KiB for 16-bit words, 512 MiB for 32-bit ones) and never walked from again. Short cycles are not marked: walking them again from each word is cheaper than a cache miss into the bitset per word. The 16-bit case takes milliseconds; the 32-bit case takes about a minute on one core and proportionally less on more.
+
+64- and 128-bit words are sampled instead. Seeded random words are followed for at most a step limit, and the histogram counts sampled words by the length of the cycle they lie on. Walks that reach the limit are reported as lying on cycles longer than it. A long cycle is more likely to be sampled than a short one, so a short cycle found by sampling is a warning, not a census.
+
+struct CycleStructure {
+    int bits = 16;
+    bool sampled = false;
+    uint64_t words = 0;                 // Words in the space, or words sampled
+    uint64_t cycles = 0;                // Exhaustive only
+    uint64_t fixed_points = 0;          // Fixed points, or sampled words that are fixed
+    map<uint64_t, uint64_t> lengths;    // Cycle length to cycles, or to sampled words on such cycles
+    uint64_t step_limit = 0;            // Sampled only
+    uint64_t unclosed = 0;              // Sampled walks that reached step_limit
+};
+
+// The deterministic 16-bit pipeline as one lookup table
+const vector<uint16_t>& deterministic_table(const CompiledPipeline& pipeline) {
+    return affine_lookup_table(pipeline.pre_quantum.map.then(pipeline.post_quantum.map));
+}
+
+// Every cycle of 'step' on all 2^WORD_BITS words (16 or 32 bits)
+template <PipelineWord Word, typename Step>
+CycleStructure exhaustive_cycles(const Step& step, WorkStealingPool& pool) {
+    static_assert(sizeof(Word) <= 4, "2^64 words cannot be visited");
+    constexpr uint64_t SHORT_CYCLE = 64;    // Longer cycles are marked in 'visited' once counted
+    const uint64_t space = uint64_t{ 1 } << WORD_BITS<Word>;
+    vector<atomic<uint64_t>> visited(space / 64);
+    auto is_visited = [&](uint64_t word) { return (visited[word / 64].load(memory_order_relaxed) >> (word % 64)) & 1; };
+
+    CycleStructure result;
+    result.bits = WORD_BITS<Word>;
+    result.words = space;
+    mutex merge_mutex;
+    pool.parallel_for(space, 1 << 12, [&](size_t begin, size_t end) {
+        map<uint64_t, uint64_t> lengths;
+        for (uint64_t start = begin; start < end; ++start) {
+            if (is_visited(start)) {
+                continue;
+            }
+            uint64_t length = 1;
+            bool smallest = true;
+            for (Word word = step(static_cast<Word>(start)); word != start; word = step(word), ++length) {
+                if (word < start) {
+                    smallest = false;
+                    break;
+                }
+            }
+            if (!smallest) {
+                continue;
+            }
+            if (length > SHORT_CYCLE) {
+                Word word = static_cast<Word>(start);
+                do {
+                    visited[word / 64].fetch_or(uint64_t{ 1 } << (word % 64), memory_order_relaxed);
+                    word = step(word);
+                } while (word != start);
+            }
+            ++lengths[length];
+        }
+        lock_guard<mutex> lock(merge_mutex);
+        for (const auto& [length, count] : lengths) {
+            result.lengths[length] += count;
+        }
+    });
+    for (const auto& [length, count] : result.lengths) {
+        result.cycles += count;
+    }
+    result.fixed_points = result.lengths.count(1) ? result.lengths[1] : 0;
+    return result;
+}
+
+// A seeded random word of any width
+template <PipelineWord Word>
+Word sample_word(uint64_t seed, uint64_t i) {
+    Word word = 0;
+    for (int shift = 0; shift < WORD_BITS<Word>; shift += 64) {
+        word |= static_cast<Word>(static_cast<Word>(splitmix64(seed ^ splitmix64(2 * i + shift / 64))) << shift);
+    }
+    return word;
+}
+
+// The cycles through 'samples' random words, each followed for at most 'step_limit' steps
+template <PipelineWord Word, typename Step>
+CycleStructure sampled_cycles(const Step& step, size_t samples, uint64_t step_limit, uint64_t seed, WorkStealingPool& pool) {
+    CycleStructure result;
+    result.bits = WORD_BITS<Word>;
+    result.sampled = true;
+    result.words = samples;
+    result.step_limit = step_limit;
+    mutex merge_mutex;
+    pool.parallel_for(samples, 1, [&](size_t begin, size_t end) {
+        map<uint64_t, uint64_t> lengths;
+        uint64_t unclosed = 0;
+        for (size_t i = begin; i < end; ++i) {
+            const Word start = sample_word<Word>(seed, i);
+            uint64_t length = 1;
+            Word word = step(start);
+            for (; word != start && length < step_limit; ++length) {
+                word = step(word);
+            }
+            if (word == start) {
+                ++lengths[length];
+            } else {
+                ++unclosed;
+            }
+        }
+        lock_guard<mutex> lock(merge_mutex);
+        for (const auto& [length, count] : lengths) {
+            result.lengths[length] += count;
+        }
+        result.unclosed += unclosed;
+    });
+    result.fixed_points = result.lengths.count(1) ? result.lengths[1] : 0;
+    return result;
+}
+
+// The cycle through 'start', in order, stopping after 'step_limit' words if it has not closed
+template <PipelineWord Word, typename Step>
+vector<Word> orbit_of(const Step& step, Word start, uint64_t step_limit, bool& closed) {
+    vector<Word> orbit{ start };
+    for (Word word = step(start); word != start && orbit.size() < step_limit; word = step(word)) {
+        orbit.push_back(word);
+    }
+    closed = step(orbit.back()) == start;
+    return orbit;
+}
+
+void print_cycle_structure(ostream& out, const CycleStructure& result) {
+    out << "Cycle structure of the deterministic pipeline (" << result.bits << "-bit words, ";
+    if (result.sampled) {
+        out << result.words << " sampled words, up to " << result.step_limit << " steps each)\n";
+        out << "sampled words that are fixed points: " << result.fixed_points << "\n";
+        out << "length      sampled words\n";
+    } else {
+        out << "exhaustive)\n";
+        out << "words " << result.words << ", cycles " << result.cycles << ", fixed points " << result.fixed_points << "\n";
+        out << "length      cycles\n";
+    }
+    char row[64];
+    for (const auto& [length, count] : result.lengths) {
+        snprintf(row, sizeof(row), "%-11llu %llu\n", static_cast<unsigned long long>(length), static_cast<unsigned long long>(count));
+        out << row;
+    }
+    if (result.sampled) {
+        out << "longer than " << result.step_limit << ": " << result.unclosed << "\n";
+    }
+}
+
+struct CycleOptions {
+    int bits = 16;
+    string orbit_start;             // Hex word whose orbit to list, if any
+    size_t samples = 0;             // 0: exhaustive for 16 and 32 bits, 4096 samples wider
+    uint64_t step_limit = 1 << 20;
+    uint64_t seed = 0;
+};
+
+template <PipelineWord Word, typename Step>
+void report_cycles(ostream& out, const Step& step, const CycleOptions& options, WorkStealingPool& pool) {
+    if (!options.orbit_start.empty()) {
+        Word start = 0;
+        if (!parse_hex_word(string_view(options.orbit_start), start)) {
+            throw invalid_argument("--orbit: expected 1-" + to_string(HEX_DIGITS<Word>) + " hex digits, got '" + options.orbit_start + "'");
+        }
+        bool closed = false;
+        const vector<Word> orbit = orbit_of(step, start, options.step_limit, closed);
+        out << "Orbit of " << options.orbit_start << ": " << (closed ? "cycle of length " : "no return within ") << orbit.size() << "\n";
+        char word[HEX_DIGITS<Word>];
+        for (size_t i = 0; i < orbit.size() && i < 32; ++i) {
+            format_hex_word(orbit[i], word);
+            out << (i > 0 ? " -> " : "") << string_view(word, sizeof(word));
+        }
+        if (orbit.size() > 32 || closed) {
+            format_hex_word(orbit[orbit.size() > 32 ? orbit.size() - 1 : 0], word);
+            out << (orbit.size() > 32 ? " -> ... -> " : " -> ") << string_view(word, sizeof(word));
+        }
+        out << "\n";
+        return;
+    }
+    if constexpr (sizeof(Word) <= 4) {
+        if (options.samples == 0) {
+            print_cycle_structure(out, exhaustive_cycles<Word>(step, pool));
+            return;
+        }
+    }
+    print_cycle_structure(out, sampled_cycles<Word>(step, options.samples ? options.samples : 4096, options.step_limit,
+                                                    options.seed, pool));
+}
+
+// --cycles and --orbit for the active pipeline at the requested width
+void analyze_cycles(ostream& out, const CycleOptions& options, WorkStealingPool& pool) {
+    auto wide = [&]<PipelineWord Word>() {
+        const CompiledWidePipeline<Word>& pipeline = active_compiled_wide_pipeline<Word>();
+        report_cycles<Word>(out, [&pipeline](Word word) { return pipeline.post_quantum.apply(pipeline.pre_quantum_apply(word)); },
+                            options, pool);
+    };
+    switch (options.bits) {
+        case 16: {
+            const uint16_t* table = deterministic_table(active_compiled_pipeline()).data();
+            report_cycles<uint16_t>(out, [table](uint16_t word) { return table[word]; }, options, pool);
+            break;
+        }
+        case 32: wide.template operator()<uint32_t>(); break;
+        case 64: wide.template operator()<uint64_t>(); break;
+        case 128: wide.template operator()<uint128_t>(); break;
+        default: throw invalid_argument("--cycles: word width must be 16, 32, 64 or 128");
+    }
+}
+
+o. Shared-Memory Channel: Snake A and Snake B as Processes
+
+verifySnakeCommunication plays both snakes in one process, so a message costs a function call. Deployed, the snakes are separate processes, and what a message costs is the trip between them. --channel measures that trip: it puts two rings of words in POSIX shared memory, forks, and runs Snake B in the child, answering batches of words from the request ring on the response ring with the batch pipeline; Snake A in the parent sends batches, waits for each answer, and records the round-trip time of every batch. At the end it checks every answer against the pipeline run locally and reports the percentiles of the round trips and the messages per second.
+
+Each ring has one writer and one reader, so it needs no lock: the writer copies words in and then publishes its new position with a release store, the reader copies them out and publishes its own, and each only ever waits for the other's position to move. A waiting side spins for a while first, since the other process usually answers within microseconds, and then sleeps on a futex on the position it is waiting for, having first raised a flag that tells the other side to wake it. The flag and the position are each written before the other side's is read, so a wake-up cannot be lost between the check and the sleep. On a single CPU the other process cannot run while this one spins, so waiting goes straight to the futex. Positions are 32-bit counters that wrap, the futex's word size; a ring holds at most 2^31 words.
+
+A sleeping side wakes every 100 ms to check that the other process is still alive, so a Snake B that died does not leave Snake A waiting forever.
+
+static_assert(atomic<uint32_t>::is_always_lock_free, "ring positions are shared between processes");
+
+// One side's position in a ring, on a cache line of its own
+struct alignas(64) RingPosition {
+    atomic<uint32_t> position{ 0 };     // Words written (head) or read (tail) so far, modulo 2^32
+    atomic<uint32_t> sleeping{ 0 };     // The other side is asleep on 'position'
+};
+
+struct RingHeader {
+    RingPosition head;                  // Advanced by the writer
+    RingPosition tail;                  // Advanced by the reader
+};
+
+int futex(atomic<uint32_t>& word, int operation, uint32_t value, const timespec* timeout = nullptr) {
+    return static_cast<int>(syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), operation, value, timeout, nullptr, 0));
+}
+
+// Spin iterations before sleeping; none when there is no other CPU to make progress
+unsigned ring_spin_limit() {
+    static const unsigned limit = thread::hardware_concurrency() > 1 ? 4096 : 0;
+    return limit;
+}
+
+// Wait until 'waited.position' is no longer 'seen' and return its new value.
+// 'peer_alive' is asked every 100 ms of sleep and throws or returns false when the other side has gone.
+uint32_t wait_for_position(RingPosition& waited, uint32_t seen, const function<bool()>& peer_alive) {
+    for (unsigned spin = 0; spin < ring_spin_limit(); ++spin) {
+        const uint32_t now = waited.position.load(memory_order_acquire);
+        if (now != seen) {
+            return now;
+        }
+#if ONEGOD_X86
+        _mm_pause();
+#endif
+    }
+    const timespec timeout{ 0, 100'000'000 };
+    for (;;) {
+        waited.sleeping.store(1, memory_order_seq_cst);
+        const uint32_t now = waited.position.load(memory_order_seq_cst);
+        if (now != seen) {
+            waited.sleeping.store(0, memory_order_relaxed);
+            return now;
+        }
+        if (futex(waited.position, FUTEX_WAIT, seen, &timeout) != 0 && errno == ETIMEDOUT
+            && waited.position.load(memory_order_acquire) == seen && !peer_alive()) {
+            throw runtime_error("channel: the other snake has gone");
+        }
+    }
+}
+
+// Publish a new position and wake the other side if it sleeps on it
+void publish_position(RingPosition& published, uint32_t position) {
+    published.position.store(position, memory_order_seq_cst);
+    if (published.sleeping.load(memory_order_seq_cst) != 0) {
+        published.sleeping.store(0, memory_order_relaxed);
+        futex(published.position, FUTEX_WAKE, INT32_MAX);
+    }
+}
+
+// A single-producer, single-consumer ring of words in memory shared with another process
+class SpscWordRing {
+public:
+    static size_t bytes_for(uint32_t capacity) { return sizeof(RingHeader) + capacity * sizeof(uint16_t); }
+
+    // 'memory' holds bytes_for(capacity) zeroed bytes; capacity is a power of two up to 2^31
+    SpscWordRing(void* memory, uint32_t capacity, function<bool()> peer_alive)
+        : header(static_cast<RingHeader*>(memory)), words(reinterpret_cast<uint16_t*>(header + 1)), mask(capacity - 1),
+          peer_alive(move(peer_alive)) {}
+
+    // Write all of 'in', waiting for room as needed
+    void write(span<const uint16_t> in) {
+        uint32_t head = header->head.position.load(memory_order_relaxed);
+        uint32_t tail = header->tail.position.load(memory_order_acquire);
+        for (size_t done = 0; done < in.size();) {
+            while (head - tail == mask + 1) {
+                tail = wait_for_position(header->tail, tail, peer_alive);
+            }
+            const size_t count = min<size_t>(in.size() - done, mask + 1 - (head - tail));
+            copy_in(head, in.subspan(done, count));
+            head += static_cast<uint32_t>(count);
+            publish_position(header->head, head);
+            done += count;
+        }
+    }
+
+    // Read at least one word and at most out.size(), waiting while the ring is empty; returns the count
+    size_t read(span<uint16_t> out) {
+        const uint32_t tail = header->tail.position.load(memory_order_relaxed);
+        uint32_t head = header->head.position.load(memory_order_acquire);
+        while (head == tail) {
+            head = wait_for_position(header->head, tail, peer_alive);
+        }
+        const size_t count = min<size_t>(out.size(), head - tail);
+        copy_out(tail, out.first(count));
+        publish_position(header->tail, tail + static_cast<uint32_t>(count));
+        return count;
+    }
+
+private:
+    RingHeader* header;
+    uint16_t* words;
+    uint32_t mask;
+    function<bool()> peer_alive;
+
+    void copy_in(uint32_t position, span<const uint16_t> in) {
+        const size_t first = position & mask;
+        const size_t before_wrap = min(in.size(), size_t{ mask } + 1 - first);
+        memcpy(words + first, in.data(), before_wrap * sizeof(uint16_t));
+        memcpy(words, in.data() + before_wrap, (in.size() - before_wrap) * sizeof(uint16_t));
+    }
+
+    void copy_out(uint32_t position, span<uint16_t> out) const {
+        const size_t first = position & mask;
+        const size_t before_wrap = min(out.size(), size_t{ mask } + 1 - first);
+        memcpy(out.data(), words + first, before_wrap * sizeof(uint16_t));
+        memcpy(out.data() + before_wrap, words, (out.size() - before_wrap) * sizeof(uint16_t));
+    }
+};
+
+// A POSIX shared memory object mapped into this process and unlinked at once:
+// it lives on in this mapping and in the mappings of the processes forked from here
+class SharedMemory {
+public:
+    explicit SharedMemory(size_t size) : size(size) {
+        const string name = "/onegod-" + to_string(getpid());
+        UniqueFd fd(shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600));
+        if (fd.get() < 0) {
+            throw system_error_for("shm_open " + name);
+        }
+        shm_unlink(name.c_str());
+        if (ftruncate(fd.get(), static_cast<off_t>(size)) != 0) {
+            throw system_error_for("shm " + name);
+        }
+        void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd.get(), 0);
+        if (mapped == MAP_FAILED) {
+            throw system_error_for("shm " + name);
+        }
+        memory = static_cast<uint8_t*>(mapped);
+    }
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+    ~SharedMemory() { munmap(memory, size); }
+
+    uint8_t* data() const { return memory; }
+
+private:
+    size_t size;
+    uint8_t* memory = nullptr;
+};
+
+struct ChannelOptions {
+    uint64_t messages = 10'000'000;     // Words Snake A sends
+    size_t batch = 64;                  // Words per round trip
+    uint32_t ring_words = 1 << 16;      // Capacity of each ring
+};
+
+struct ChannelStats {
+    uint64_t messages = 0;
+    uint64_t round_trips = 0;
+    uint64_t mismatched = 0;            // Answers that differ from the local pipeline
+    double seconds = 0;
+    array<double, 5> latency_ns{};      // Round trip: 50th, 90th, 99th, 99.9th percentile and maximum
+};
+
+// Snake B: answer every word of 'requests' on 'responses' until 'messages' have been answered
+void snake_b_serve(SpscWordRing& requests, SpscWordRing& responses, const CompiledPipeline& pipeline, uint64_t messages,
+                   size_t batch) {
+    vector<uint16_t> words(batch);
+    for (uint64_t answered = 0; answered < messages;) {
+        const size_t count = requests.read(span<uint16_t>(words.data(), min<uint64_t>(batch, messages - answered)));
+        snake_transformation_pipeline_batch(pipeline, span<const uint16_t>(words.data(), count), span<uint16_t>(words.data(), count),
+                                            answered, SNAKE_B_STREAM);
+        responses.write(span<const uint16_t>(words.data(), count));
+        answered += count;
+    }
+}
+
+// Run Snake B in a child process and Snake A here, one batch in flight at a time
+ChannelStats run_channel(const ChannelOptions& options, const CompiledPipeline& pipeline) {
+    if (options.batch == 0 || options.batch > options.ring_words || !has_single_bit(options.ring_words)) {
+        throw invalid_argument("channel: the batch must be from 1 word to the ring capacity, a power of two");
+    }
+    const size_t ring_bytes = SpscWordRing::bytes_for(options.ring_words);
+    SharedMemory shared(2 * ring_bytes);
+
+    // The child is a copy of this thread alone, and a lock another thread (the metrics writer, say) holds at
+    // the fork stays held in it forever. Run one word through the pipeline here first, so that this thread's
+    // metrics block and every lazily built table the child will use exist before the fork.
+    array<uint16_t, 1> warm{};
+    snake_transformation_pipeline_batch(pipeline, span<const uint16_t>(warm), span<uint16_t>(warm), 0, SNAKE_B_STREAM);
+
+    cout.flush();
+    const pid_t parent = getpid();
+    const pid_t child = fork();
+    if (child < 0) {
+        throw system_error_for("fork");
+    }
+    // WNOWAIT leaves an exited child to be reaped below
+    auto alive = [child, parent]() {
+        if (child == 0) {
+            return getppid() == parent;
+        }
+        siginfo_t info{};
+        return waitid(P_PID, static_cast<id_t>(child), &info, WEXITED | WNOHANG | WNOWAIT) == 0 && info.si_pid == 0;
+    };
+    SpscWordRing requests(shared.data(), options.ring_words, alive);
+    SpscWordRing responses(shared.data() + ring_bytes, options.ring_words, alive);
+    if (child == 0) {
+        // The child leaves with _exit so nothing of the parent's (buffers, destructors) runs twice
+        try {
+            snake_b_serve(requests, responses, pipeline, options.messages, options.batch);
+        } catch (const exception& e) {
+            cerr << "Error: Snake B: " << e.what() << endl;
+            _exit(1);
+        }
+        _exit(0);
+    }
+
+    ChannelStats stats;
+    vector<uint16_t> sent(options.messages);
+    vector<uint16_t> answers(options.messages);
+    for (uint64_t i = 0; i < options.messages; ++i) {
+        sent[i] = static_cast<uint16_t>(splitmix64(pipeline.seed ^ i));
+    }
+    vector<uint32_t> round_trips;
+    round_trips.reserve(options.messages / options.batch + 1);
+    const auto start = chrono::steady_clock::now();
+    try {
+        for (uint64_t first = 0; first < options.messages; first += options.batch) {
+            const size_t count = min<uint64_t>(options.batch, options.messages - first);
+            const auto sent_at = chrono::steady_clock::now();
+            requests.write(span<const uint16_t>(sent.data() + first, count));
+            for (size_t received = 0; received < count;) {
+                received += responses.read(span<uint16_t>(answers.data() + first + received, count - received));
+            }
+            const auto nanoseconds = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - sent_at).count();
+            round_trips.push_back(static_cast<uint32_t>(min<int64_t>(nanoseconds, UINT32_MAX)));
+        }
+    } catch (...) {
+        kill(child, SIGKILL);
+        waitpid(child, nullptr, 0);
+        throw;
+    }
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    int status = 0;
+    if (waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        throw runtime_error("channel: Snake B did not finish cleanly");
+    }
+
+    vector<uint16_t> expected(options.messages);
+    snake_transformation_pipeline_batch(pipeline, sent, expected, 0, SNAKE_B_STREAM);
+    for (uint64_t i = 0; i < options.messages; ++i) {
+        stats.mismatched += answers[i] != expected[i];
+    }
+    stats.messages = options.messages;
+    stats.round_trips = round_trips.size();
+    sort(round_trips.begin(), round_trips.end());
+    const double percentiles[] = { 0.5, 0.9, 0.99, 0.999, 1.0 };
+    for (size_t p = 0; p < stats.latency_ns.size() && !round_trips.empty(); ++p) {
+        const size_t rank = min(round_trips.size() - 1, static_cast<size_t>(percentiles[p] * round_trips.size()));
+        stats.latency_ns[p] = round_trips[rank];
+    }
+    return stats;
+}
+
+void print_channel_stats(ostream& out, const ChannelStats& stats) {
+    const streamsize precision = out.precision();
+    out << "Channel: " << stats.messages << " words in " << stats.round_trips << " round trips, " << fixed << setprecision(3)
+        << stats.seconds << " s, " << setprecision(2) << stats.messages / stats.seconds / 1e6 << " M words/s\n";
+    out << "round trip ns: p50 " << setprecision(0) << stats.latency_ns[0] << ", p90 " << stats.latency_ns[1] << ", p99 "
+        << stats.latency_ns[2] << ", p99.9 " << stats.latency_ns[3] << ", max " << stats.latency_ns[4] << "\n";
+    out << "answers mismatched: " << stats.mismatched << "\n";
+    out.unsetf(ios::floatfield);
+    out.precision(precision);
+}
+
+p. Session Engine: Many Conversations on a Few Threads
+
+verifySnakeCommunication holds one conversation and blocks at every step. A server holds many at once, each pair of snakes with its own keys and possibly its own transformers, and cannot give each a thread. The session engine runs each conversation as a C++20 coroutine instead. A conversation is written as plain sequential code, but every message it sends is a co_await that parks the coroutine in the engine's queue of ready messages; nothing runs it again until its answer is ready. A parked conversation is just its coroutine frame, a hundred-odd bytes, so tens of thousands cost a few megabytes.
+
+The engine works in rounds. It takes every message queued since the last round as one batch, sorts it by compiled pipeline, and has the pool transform it in ranges: the folded stages of each run of messages sharing a pipeline go through the vector kernels together, and only the quantum stage is taken word by word, each with the key and message number of its own conversation. A range then resumes the conversations whose answers it holds, which run up to their next message and queue it for the next round. So with every conversation waiting on its answer, a round transforms one message from each of them in a single batch.
+
+Each side of a conversation is an endpoint: a compiled pipeline, a key, and the number of messages it has answered. A message to an endpoint is transformed exactly as CompiledPipeline::run would transform it with that key and number.
 
-// Reflect using a reflector
-uint16_t reflect(uint16_t word, uint16_t reflector) {
-    return word ^ reflector;
-}
+struct SessionEndpoint {
+    const CompiledPipeline* pipeline;
+    QuantumKey key;
+    uint64_t answered = 0;
+};
 
-e. Define Transformers (Three Transformers)
+class SessionEngine;
 
-class Transformer {
+// A conversation. It starts suspended; SessionEngine::spawn takes it over and run starts it.
+class SessionTask {
 public:
-    string name;
-    vector<function<uint16_t(uint16_t)>> operations;
+    struct promise_type {
+        exception_ptr error;
+
+        // Frame bytes of every session, for the memory report
+        static atomic<uint64_t>& frame_bytes() {
+            static atomic<uint64_t> bytes{ 0 };
+            return bytes;
+        }
 
-    Transformer(string name, vector<function<uint16_t(uint16_t)>> ops) : name(name), operations(ops) {}
+        static void* operator new(size_t size) {
+            frame_bytes().fetch_add(size, memory_order_relaxed);
+            return ::operator new(size);
+        }
 
-    uint16_t apply(uint16_t word) const {
-        cout << "\nApplying " << name << ":\n";
-        for (auto& op : operations) {
-            uint16_t before = word;
-            word = op(word);
-            // Display operation name
-            string op_name = "Unknown";
-            // Identify operation name based on function pointer
-            // Note: In C++, identifying the exact lambda or function name is non-trivial.
-            // For simplicity, we won't display the exact operation name here.
-            // Instead, you can enhance this by using a more sophisticated method or by defining named functions.
-            // Here, we'll skip the operation name.
-            // Alternatively, you can use separate functions with distinct names.
-
-            // For demonstration, we'll print the binary before and after.
-            cout << "Before: " << bitset<16>(before) << " -> After: " << bitset<16>(word) << endl;
+        static void operator delete(void* frame, size_t size) {
+            frame_bytes().fetch_sub(size, memory_order_relaxed);
+            ::operator delete(frame);
+        }
+
+        SessionTask get_return_object() { return SessionTask(coroutine_handle<promise_type>::from_promise(*this)); }
+        suspend_always initial_suspend() noexcept { return {}; }
+        suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { error = current_exception(); }
+    };
+
+    explicit SessionTask(coroutine_handle<promise_type> handle) : handle(handle) {}
+    SessionTask(SessionTask&& other) noexcept : handle(exchange(other.handle, nullptr)) {}
+    SessionTask(const SessionTask&) = delete;
+    SessionTask& operator=(const SessionTask&) = delete;
+    ~SessionTask() {
+        if (handle) {
+            handle.destroy();
         }
-        return word;
     }
+
+private:
+    friend class SessionEngine;
+    coroutine_handle<promise_type> handle;
 };
 
-f. Define Keys
+struct SessionEngineStats {
+    uint64_t sessions = 0;
+    uint64_t messages = 0;
+    uint64_t rounds = 0;
+    uint64_t largest_batch = 0;
+};
 
-const uint16_t KEY_333 = 0x0333; // Hexadecimal representation of 333
-const uint16_t KEY_555 = 0x0555; // Hexadecimal representation of 555
-const uint16_t KEY_AAA = 0x0AAA; // Hexadecimal representation of AAA
+class SessionEngine {
+public:
+    // co_await engine.send(endpoint, word) parks the conversation until the endpoint's answer is ready
+    struct SendAwaiter {
+        SessionEngine& engine;
+        SessionEndpoint& endpoint;
+        uint16_t word;
+        uint16_t answer = 0;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(coroutine_handle<> waiting) { engine.enqueue({ waiting, &endpoint, word, &answer }); }
+        uint16_t await_resume() const noexcept { return answer; }
+    };
 
-g. Initialize Transformers with Operations
+    SendAwaiter send(SessionEndpoint& endpoint, uint16_t word) { return SendAwaiter{ *this, endpoint, word }; }
 
-// Define operation sequences for each transformer
-Transformer transformer1("Transformer1", {
-    [](uint16_t w) -> uint16_t { return rotate_left(w, 3); },
-    [=](uint16_t w) -> uint16_t { return xor_with_key(w, KEY_333); }
-});
+    void spawn(SessionTask task) {
+        tasks.push_back(move(task));
+        ++stats.sessions;
+    }
 
-Transformer transformer2("Transformer2", {
-    [](uint16_t w) -> uint16_t { return invert_bits(w); },
-    [](uint16_t w) -> uint16_t { return rotate_right(w, 2); }
-});
+    // Run every spawned conversation to its end; rethrows the first exception a conversation let escape
+    SessionEngineStats run(WorkStealingPool& pool) {
+        pool.parallel_for(tasks.size(), 256, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                tasks[i].handle.resume();
+            }
+        });
+        vector<Message> batch;
+        for (;;) {
+            {
+                lock_guard<mutex> lock(queue_mutex);
+                batch.swap(ready);
+            }
+            if (batch.empty()) {
+                break;
+            }
+            if (!is_sorted(batch.begin(), batch.end(), by_pipeline)) {
+                stable_sort(batch.begin(), batch.end(), by_pipeline);
+            }
+            stats.messages += batch.size();
+            stats.largest_batch = max<uint64_t>(stats.largest_batch, batch.size());
+            ++stats.rounds;
+            pool.parallel_for(batch.size(), 1024, [&](size_t begin, size_t end) { answer(span<Message>(batch).subspan(begin, end - begin)); });
+            batch.clear();
+        }
+        for (SessionTask& task : tasks) {
+            if (!task.handle.done()) {
+                throw logic_error("session engine: a conversation is waiting on something other than the engine");
+            }
+            if (task.handle.promise().error) {
+                rethrow_exception(task.handle.promise().error);
+            }
+        }
+        return stats;
+    }
 
-Transformer transformer3("Transformer3", {
-    [=](uint16_t w) -> uint16_t { return reflect(w, REFLECTOR_FFF); },
-    [=](uint16_t w) -> uint16_t { return xor_with_key(w, KEY_555); },
-    [](uint16_t w) -> uint16_t { return rotate_left(w, 1); }
-});
+private:
+    struct Message {
+        coroutine_handle<> waiting;
+        SessionEndpoint* endpoint;
+        uint16_t word;
+        uint16_t* answer;
+    };
 
-// Collect all transformers
-const vector<Transformer> TRANSFORMERS = { transformer1, transformer2, transformer3 };
+    static bool by_pipeline(const Message& a, const Message& b) { return a.endpoint->pipeline < b.endpoint->pipeline; }
+
+    vector<SessionTask> tasks;
+    mutex queue_mutex;
+    vector<Message> ready;          // Messages sent since the batch being answered was taken
+    SessionEngineStats stats;
 
-h. Define Crowns of Weights (Crowned Primes)
+    void enqueue(const Message& message) {
+        lock_guard<mutex> lock(queue_mutex);
+        ready.push_back(message);
+    }
 
-struct CrownedPrime {
-    uint16_t prime;
-    uint16_t weight;
+    // Transform one range of a batch, a block of messages sharing a pipeline at a time, then resume its senders
+    static void answer(span<Message> messages) {
+        uint16_t words[256];
+        for (size_t first = 0; first < messages.size();) {
+            const CompiledPipeline& pipeline = *messages[first].endpoint->pipeline;
+            size_t count = 1;
+            while (first + count < messages.size() && count < size(words) && messages[first + count].endpoint->pipeline == &pipeline) {
+                ++count;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                words[i] = messages[first + i].word;
+            }
+            ThreadMetrics* metrics = stage_metrics();
+            if constexpr (METRICS_ENABLED) {
+                metrics->stages[METRIC_BATCH_PIPELINE].count(count);
+            }
+            StageTimer timer(metrics, METRIC_BATCH_PIPELINE, METRICS_ENABLED);
+            if (pipeline.mode == PipelineMode::CIPHER) {
+                pipeline.pre_quantum.apply(words, words, count);
+            }
+            for (size_t i = 0; i < count; ++i) {
+                SessionEndpoint& endpoint = *messages[first + i].endpoint;
+                const uint64_t index = endpoint.answered++;
+                words[i] = pipeline.mode == PipelineMode::CIPHER ? static_cast<uint16_t>(words[i] ^ quantum_bits(endpoint.key, index))
+                                                                 : quantum_measure(words[i], endpoint.key, index);
+            }
+            pipeline.post_quantum.apply(words, words, count);
+            for (size_t i = 0; i < count; ++i) {
+                *messages[first + i].answer = words[i];
+            }
+            first += count;
+        }
+        for (const Message& message : messages) {
+            message.waiting.resume();
+        }
+    }
+};
 
-    CrownedPrime(uint16_t p, uint16_t w) : prime(p), weight(w) {}
+// Two snakes, each answering on an endpoint of its own
+struct SnakeSession {
+    SessionEndpoint a;
+    SessionEndpoint b;
+    uint16_t word;                  // The first word Snake A sends, then the last it answered
 };
 
-// Apply crowns of weights
-uint16_t apply_crowned_primes(uint16_t word, const vector<CrownedPrime>& crowned_primes) {
-    cout << "\nApplying Crowns of Weights:\n";
-    for (const auto& cp : crowned_primes) {
-        uint16_t before = word;
-        uint16_t transformation = cp.prime * cp.weight;
-        word = xor_with_key(word, transformation);
-        cout << "CrownedPrime " << cp.prime << " * " << cp.weight << ": " 
-             << bitset<16>(before) << " -> " << bitset<16>(word) << endl;
+// verifySnakeCommunication's exchange as a conversation: Snake A sends a word, Snake B
+// answers it, and Snake A's answer to that is the next word sent
+SessionTask snake_conversation(SessionEngine& engine, SnakeSession& session, uint32_t exchanges) {
+    uint16_t word = session.word;
+    for (uint32_t step = 0; step < exchanges; ++step) {
+        const uint16_t answer = co_await engine.send(session.b, word);
+        word = co_await engine.send(session.a, answer);
     }
-    return word;
+    session.word = word;
 }
 
-i. Initialize Crowned Primes
+struct SessionOptions {
+    size_t sessions = 10'000;
+    uint32_t exchanges = 100;
+};
 
-const vector<CrownedPrime> CROWNED_PRIMES = {
-    CrownedPrime(3, KEY_333), // 3 * 0x0333
-    CrownedPrime(5, KEY_555), // 5 * 0x0555
-    CrownedPrime(7, KEY_AAA)  // 7 * 0x0AAA
+struct SessionReport {
+    SessionEngineStats engine;
+    double seconds = 0;
+    uint64_t frame_bytes = 0;       // Coroutine frames of all sessions while parked
+    uint64_t mismatched = 0;        // Sessions whose last word differs from running their exchanges one by one
 };
 
-j. Define Quantum-Inspired Operators
+// Hold options.sessions conversations on the pool under the active pipeline, each side keyed by its own
+// seed and stream, and check each against the same exchanges run one word at a time
+SessionReport run_sessions(const SessionOptions& options, const CompiledPipeline& pipeline, WorkStealingPool& pool) {
+    vector<SnakeSession> sessions(options.sessions);
+    for (size_t s = 0; s < sessions.size(); ++s) {
+        const uint64_t seed = splitmix64(pipeline.seed ^ s);
+        sessions[s].a = { &pipeline, QuantumKey{ seed, SNAKE_A_STREAM } };
+        sessions[s].b = { &pipeline, QuantumKey{ seed, SNAKE_B_STREAM } };
+        sessions[s].word = static_cast<uint16_t>(seed >> 48);
+    }
 
-To enhance transformation complexity and introduce quantum-like unpredictability, we’ll simulate a simple quantum-inspired transformation.
+    SessionReport report;
+    SessionEngine engine;
+    const uint64_t frames_before = SessionTask::promise_type::frame_bytes().load();
+    for (SnakeSession& session : sessions) {
+        engine.spawn(snake_conversation(engine, session, options.exchanges));
+    }
+    report.frame_bytes = SessionTask::promise_type::frame_bytes().load() - frames_before;
+    const auto start = chrono::steady_clock::now();
+    report.engine = engine.run(pool);
+    report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    atomic<uint64_t> mismatched{ 0 };
+    pool.parallel_for(sessions.size(), 256, [&](size_t begin, size_t end) {
+        for (size_t s = begin; s < end; ++s) {
+            CompiledPipeline keyed = pipeline;
+            keyed.seed = sessions[s].a.key.seed;
+            uint16_t word = static_cast<uint16_t>(keyed.seed >> 48);
+            for (uint32_t step = 0; step < options.exchanges; ++step) {
+                word = keyed.run(keyed.run(word, step, SNAKE_B_STREAM), step, SNAKE_A_STREAM);
+            }
+            mismatched += word != sessions[s].word;
+        }
+    });
+    report.mismatched = mismatched;
+    return report;
+}
 
-struct QuantumBit {
-    float state; // Probability of being 1
+void print_session_report(ostream& out, const SessionReport& report) {
+    const SessionEngineStats& stats = report.engine;
+    out << "Sessions: " << stats.sessions << " conversations, " << stats.messages << " messages in " << stats.rounds
+        << " batches (largest " << stats.largest_batch << "), " << report.seconds << " s, "
+        << stats.messages / report.seconds / 1e6 << " M messages/s\n";
+    out << "bytes per parked session: " << report.frame_bytes / max<uint64_t>(stats.sessions, 1) << " frame + "
+        << sizeof(SnakeSession) << " state\n";
+    out << "sessions mismatched: " << report.mismatched << "\n";
+}
 
-    QuantumBit(float s = 0.5f) : state(s) {}
+q. Avalanche Statistics
 
-    // Simulate Hadamard-like transformation (superposition)
-    void apply_hadamard() {
-        state = 0.5f;
+A good mixing function changes each output bit with probability one half when any one input bit flips, and sets each output bit half the time. --avalanche measures both for the active pipeline over all 65536 inputs: every input is transformed as it is and with each of its 16 bits flipped, at the same word number, so the flipped word meets the same measurement or keystream, and the differences are tallied into a 16x16 avalanche matrix (how often output bit j changed when input bit i flipped), a histogram of how many output bits one flip changed, and the bias of each output bit. That is 17 x 65536 pipeline evaluations, run through the batch pipeline on the pool a block at a time, with each thread tallying its blocks and the totals merged at the end.
+
+Bits are tallied 16 words at a time under AVX2: shifting each byte's bit k to its top and taking the byte sign mask gives bit k of all 16 words' low and high bytes in one 32-bit mask, and two popcounts of it count output bits k and k + 8; the words' own popcounts, for the histogram, come from a nibble lookup with a byte shuffle.
+
+The figures describe the pipeline as it is, which compare configurations fast and also say plainly what the game's deterministic stages are. In quantum mode the measurement forgets its input, so no flip reaches the output and the matrix is all zero. In cipher mode the keystream cancels out of every difference and what remains is the folded GF(2) affine map: flipping input bit i always changes exactly the output bits of column i, so every entry is 0 or 100%.
+
+struct AvalancheStats {
+    uint64_t words = 0;                             // Inputs; each is also flipped at every bit
+    array<array<uint64_t, 16>, 16> changed{};       // [input bit][output bit]: flips that changed the output bit
+    array<uint64_t, 17> distance{};                 // Flips by the number of output bits they changed
+    array<uint64_t, 16> ones{};                     // Unflipped outputs with the bit set
+};
+
+// counts[k] += words with bit k set; if 'weights' is given, weights[popcount(word)] += 1.
+// Returns how many words the kernel took.
+#if ONEGOD_X86
+__attribute__((target("avx2,popcnt")))
+size_t tally_bits_avx2(const uint16_t* words, size_t count, uint64_t* counts, uint64_t* weights) {
+    const __m256i nibble_popcount = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                     0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+        for (int k = 0; k < 8; ++k) {
+            // Byte 2w of the mask is bit k of word w, byte 2w + 1 its bit k + 8
+            const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(x, 7 - k)));
+            counts[k] += _mm_popcnt_u32(mask & 0x55555555u);
+            counts[k + 8] += _mm_popcnt_u32(mask & 0xAAAAAAAAu);
+        }
+        if (weights != nullptr) {
+            __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(nibble_popcount, _mm256_and_si256(x, low_nibbles)),
+                                            _mm256_shuffle_epi8(nibble_popcount, _mm256_and_si256(_mm256_srli_epi16(x, 4), low_nibbles)));
+            bytes = _mm256_add_epi16(_mm256_and_si256(bytes, _mm256_set1_epi16(0xFF)), _mm256_srli_epi16(bytes, 8));
+            alignas(32) uint16_t popcounts[16];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(popcounts), bytes);
+            for (uint16_t popcount : popcounts) {
+                ++weights[popcount];
+            }
+        }
+    }
+    return i;
+}
+#endif
+
+void tally_bits(const uint16_t* words, size_t count, uint64_t* counts, uint64_t* weights) {
+    size_t i = 0;
+#if ONEGOD_X86
+    if (simd_level() >= SimdLevel::AVX2) {
+        i = tally_bits_avx2(words, count, counts, weights);
+    }
+#endif
+    for (; i < count; ++i) {
+        for (int k = 0; k < 16; ++k) {
+            counts[k] += (words[i] >> k) & 1;
+        }
+        if (weights != nullptr) {
+            ++weights[popcount(words[i])];
+        }
     }
+}
+
+AvalancheStats avalanche_stats(const CompiledPipeline& pipeline, uint64_t stream, WorkStealingPool& pool) {
+    constexpr size_t BLOCK = 4096;
+    AvalancheStats stats;
+    stats.words = 65536;
+    mutex merge_mutex;
+    pool.parallel_for(65536 / BLOCK, 1, [&](size_t begin, size_t end) {
+        AvalancheStats local;
+        uint16_t inputs[BLOCK], base[BLOCK], flipped[BLOCK];
+        for (size_t block = begin; block < end; ++block) {
+            const uint64_t first = block * BLOCK;
+            for (size_t i = 0; i < BLOCK; ++i) {
+                inputs[i] = static_cast<uint16_t>(first + i);
+            }
+            snake_transformation_pipeline_batch(pipeline, span<const uint16_t>(inputs), span<uint16_t>(base), first, stream);
+            tally_bits(base, BLOCK, local.ones.data(), nullptr);
+            for (int bit = 0; bit < 16; ++bit) {
+                for (size_t i = 0; i < BLOCK; ++i) {
+                    flipped[i] = static_cast<uint16_t>(inputs[i] ^ (1u << bit));
+                }
+                snake_transformation_pipeline_batch(pipeline, span<const uint16_t>(flipped), span<uint16_t>(flipped), first, stream);
+                for (size_t i = 0; i < BLOCK; ++i) {
+                    flipped[i] ^= base[i];
+                }
+                tally_bits(flipped, BLOCK, local.changed[bit].data(), local.distance.data());
+            }
+        }
+        lock_guard<mutex> lock(merge_mutex);
+        for (int in = 0; in < 16; ++in) {
+            for (int out = 0; out < 16; ++out) {
+                stats.changed[in][out] += local.changed[in][out];
+            }
+        }
+        for (int bit = 0; bit < 16; ++bit) {
+            stats.ones[bit] += local.ones[bit];
+        }
+        for (int d = 0; d <= 16; ++d) {
+            stats.distance[d] += local.distance[d];
+        }
+    });
+    return stats;
+}
 
-    // Simulate measurement
-    int measure() const {
-        float rand_val = static_cast<float>(rand()) / RAND_MAX;
-        return (rand_val < state) ? 1 : 0;
+// The matrix in percent (rows are input bits, columns output bits), then the
+// distance histogram, the output bit biases and two summary figures: the mean
+// distance of the matrix entries from 50% and the largest bias
+void print_avalanche_stats(ostream& out, const AvalancheStats& stats) {
+    const streamsize precision = out.precision();
+    const double flips = static_cast<double>(stats.words);
+    out << fixed << setprecision(1);
+    out << "Avalanche matrix, % of " << stats.words << " flips that changed each output bit\nin\\out";
+    for (int bit = 15; bit >= 0; --bit) {
+        out << setw(6) << bit;
+    }
+    out << "\n";
+    double deviation = 0;
+    for (int in = 15; in >= 0; --in) {
+        out << setw(6) << in;
+        for (int bit = 15; bit >= 0; --bit) {
+            const double p = stats.changed[in][bit] / flips;
+            deviation += abs(p - 0.5);
+            out << setw(6) << 100 * p;
+        }
+        out << "\n";
+    }
+    out << "output bits changed by one flip:";
+    for (int d = 0; d <= 16; ++d) {
+        out << " " << d << ":" << stats.distance[d];
+    }
+    out << "\noutput bit bias (% set - 50):";
+    double worst_bias = 0;
+    for (int bit = 15; bit >= 0; --bit) {
+        const double bias = stats.ones[bit] / flips - 0.5;
+        worst_bias = max(worst_bias, abs(bias));
+        out << " " << 100 * bias;
     }
+    out << "\nmean |p - 50%| " << setprecision(2) << 100 * deviation / 256 << "%, largest bias " << 100 * worst_bias << "%\n";
+    out.unsetf(ios::floatfield);
+    out.precision(precision);
+}
+
+r. Metrics Snapshots
+
+The stage counters of the trace policy are read by --metrics: a side thread sums every thread's counters at an interval (one second by default) and writes the totals to a file, in Prometheus text format or as JSON, for a local scraper to collect. Each snapshot is written beside the file and renamed over it, so a reader never sees half of one, and a last snapshot is written when the program ends. Counters are cumulative from the start of the process; a stage appears once it has been called. Latencies are converted from ticks to seconds with a tick rate measured once against the steady clock.
+
+Stages are the transformers, by name, then crowned_primes and quantum, all counted by snake_transformation_pipeline; hex_codec, the snakes' parsing and formatting of messages; and batch_pipeline, every call of the batch entry point, whose words are the words it transformed. The batch path folds the transformers into one map, so only the interpreted pipeline reports them one by one. Their calls are the pipeline's runs, a run calling each stage once (the last transformer slot once for each transformer from the eighth on), and their timings come from the copy of the stages that every 64th run takes.
+
+struct StageSnapshot {
+    string name;
+    uint64_t calls = 0;
+    uint64_t words = 0;
+    uint64_t timed = 0;
+    uint64_t ticks = 0;
+    array<uint64_t, METRIC_BUCKETS> histogram{};
 };
 
-// Quantum-inspired transformation
-uint16_t quantum_inspired_transform(uint16_t word) {
-    QuantumBit qubits[16];
-    // Initialize qubits based on the current word
-    for (int i = 0; i < 16; ++i) {
-        qubits[i].state = ((word >> i) & 1) ? 1.0f : 0.0f;
+string metric_stage_name(size_t stage) {
+    const auto& transformers = active_pipeline().transformers;
+    if (stage < METRIC_TRANSFORMERS) {
+        string name = stage < transformers.size() ? transformers[stage].name : "transformer" + to_string(stage + 1);
+        return stage == METRIC_TRANSFORMERS - 1 && transformers.size() > METRIC_TRANSFORMERS ? name + "+" : name;
+    }
+    switch (stage) {
+        case METRIC_CROWNED_PRIMES: return "crowned_primes";
+        case METRIC_QUANTUM: return "quantum";
+        case METRIC_HEX_CODEC: return "hex_codec";
+        default: return "batch_pipeline";
+    }
+}
+
+// The sums over every thread of the stages called so far
+vector<StageSnapshot> snapshot_metrics() {
+    array<StageSnapshot, METRIC_STAGES> totals;
+    uint64_t pipeline_runs = 0;
+    {
+        MetricsRegistry& registry = metrics_registry();
+        lock_guard<mutex> lock(registry.registry_mutex);
+        for (const auto& thread : registry.threads) {
+            pipeline_runs += thread->pipeline_runs.load(memory_order_relaxed);
+            for (size_t stage = 0; stage < METRIC_STAGES; ++stage) {
+                const StageCounters& counters = thread->stages[stage];
+                StageSnapshot& total = totals[stage];
+                total.calls += counters.calls.load(memory_order_relaxed);
+                total.words += counters.words.load(memory_order_relaxed);
+                total.timed += counters.timed.load(memory_order_relaxed);
+                total.ticks += counters.ticks.load(memory_order_relaxed);
+                for (int b = 0; b < METRIC_BUCKETS; ++b) {
+                    total.histogram[b] += counters.histogram[b].load(memory_order_relaxed);
+                }
+            }
+        }
+    }
+    // Every run of the interpreted pipeline calls each of its stages once, the last transformer slot once per extra transformer
+    const size_t transformers = active_pipeline().transformers.size();
+    for (size_t stage = 0; stage < METRIC_QUANTUM + 1; ++stage) {
+        uint64_t per_run = 1;
+        if (stage < METRIC_TRANSFORMERS) {
+            per_run = stage < METRIC_TRANSFORMERS - 1 ? stage < transformers : transformers - min(transformers, stage);
+        }
+        totals[stage].calls = totals[stage].words = pipeline_runs * per_run;
+    }
+    vector<StageSnapshot> called;
+    for (size_t stage = 0; stage < METRIC_STAGES; ++stage) {
+        if (totals[stage].calls > 0) {
+            totals[stage].name = metric_stage_name(stage);
+            called.push_back(totals[stage]);
+        }
     }
+    return called;
+}
 
-    // Apply Hadamard-like transformation
-    for (int i = 0; i < 16; ++i) {
-        qubits[i].apply_hadamard();
+// metric_ticks per second, measured over 20 ms on first use
+double metric_ticks_per_second() {
+    static const double rate = [] {
+        if constexpr (!ONEGOD_X86) {
+            return 1e9;
+        }
+        const auto wall_start = chrono::steady_clock::now();
+        const uint64_t start = metric_ticks();
+        this_thread::sleep_for(chrono::milliseconds(20));
+        const uint64_t end = metric_ticks();
+        return (end - start) / chrono::duration<double>(chrono::steady_clock::now() - wall_start).count();
+    }();
+    return rate;
+}
+
+string escape_metric_label(const string& text) {
+    string escaped;
+    for (char c : text) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+        }
+        escaped += c == '\n' ? ' ' : c;
     }
+    return escaped;
+}
 
-    // Measure qubits to get the transformed word
-    uint16_t transformed_word = 0;
-    for (int i = 0; i < 16; ++i) {
-        transformed_word |= (qubits[i].measure() << i);
+string format_metrics_prometheus(const vector<StageSnapshot>& stages, double ticks_per_second) {
+    ostringstream out;
+    out << setprecision(9);
+    out << "# HELP onegod_stage_calls_total Calls of each pipeline stage.\n# TYPE onegod_stage_calls_total counter\n";
+    for (const auto& stage : stages) {
+        out << "onegod_stage_calls_total{stage=\"" << escape_metric_label(stage.name) << "\"} " << stage.calls << "\n";
+    }
+    out << "# HELP onegod_stage_words_total Words through each pipeline stage.\n# TYPE onegod_stage_words_total counter\n";
+    for (const auto& stage : stages) {
+        out << "onegod_stage_words_total{stage=\"" << escape_metric_label(stage.name) << "\"} " << stage.words << "\n";
+    }
+    out << "# HELP onegod_stage_seconds Latency of the sampled calls of each pipeline stage.\n# TYPE onegod_stage_seconds histogram\n";
+    for (const auto& stage : stages) {
+        const string label = "stage=\"" + escape_metric_label(stage.name) + "\"";
+        uint64_t cumulative = 0;
+        for (int b = 0; b < METRIC_BUCKETS - 1; ++b) {
+            cumulative += stage.histogram[b];
+            out << "onegod_stage_seconds_bucket{" << label << ",le=\"" << ldexp(1.0, b) / ticks_per_second << "\"} " << cumulative << "\n";
+        }
+        out << "onegod_stage_seconds_bucket{" << label << ",le=\"+Inf\"} " << stage.timed << "\n";
+        out << "onegod_stage_seconds_sum{" << label << "} " << stage.ticks / ticks_per_second << "\n";
+        out << "onegod_stage_seconds_count{" << label << "} " << stage.timed << "\n";
     }
+    return out.str();
+}
 
-    cout << "\nQuantum-Inspired Transformation:\n";
-    cout << "Before: " << bitset<16>(word) << " -> After: " << bitset<16>(transformed_word) << endl;
-    return transformed_word;
+string format_metrics_json(const vector<StageSnapshot>& stages, double ticks_per_second) {
+    ostringstream out;
+    out << setprecision(9);
+    out << "{\"ticks_per_second\": " << ticks_per_second << ", \"sample_every\": " << METRIC_SAMPLE_EVERY << ", \"stages\": [";
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const StageSnapshot& stage = stages[i];
+        out << (i > 0 ? ", " : "") << "{\"stage\": \"" << escape_metric_label(stage.name) << "\", \"calls\": " << stage.calls
+            << ", \"words\": " << stage.words << ", \"timed\": " << stage.timed << ", \"ticks\": " << stage.ticks
+            << ", \"histogram\": [";
+        for (int b = 0; b < METRIC_BUCKETS; ++b) {
+            out << (b > 0 ? ", " : "") << stage.histogram[b];
+        }
+        out << "]}";
+    }
+    out << "]}\n";
+    return out.str();
 }
 
-k. Define the Snake Transformation Pipeline
+// Writes a snapshot every 'interval' from a thread of its own, and a last one when destroyed
+class MetricsWriter {
+public:
+    MetricsWriter(string path, bool json, chrono::milliseconds interval) : path(move(path)), json(json), interval(interval) {
+        if constexpr (!METRICS_ENABLED) {
+            throw invalid_argument("--metrics: this build has ONEGOD_METRICS=0");
+        }
+        write_snapshot();
+        writer = thread([this] { run(); });
+    }
 
-uint16_t snake_transformation_pipeline(uint16_t word) {
-    cout << "\n=== Snake Transformation Pipeline ===\n";
-    cout << "Initial Word: " << bitset<16>(word) << " (" << hex << word << dec << ")\n";
+    MetricsWriter(const MetricsWriter&) = delete;
+    MetricsWriter& operator=(const MetricsWriter&) = delete;
 
-    // Apply all transformers
-    for (const auto& transformer : TRANSFORMERS) {
-        word = transformer.apply(word);
+    ~MetricsWriter() {
+        {
+            lock_guard<mutex> lock(stop_mutex);
+            stopping = true;
+        }
+        stop_signal.notify_one();
+        writer.join();
+        try {
+            write_snapshot();
+        } catch (const exception& e) {
+            cerr << "Warning: " << e.what() << endl;
+        }
     }
 
-    // Apply Crowns of Weights
-    word = apply_crowned_primes(word, CROWNED_PRIMES);
+private:
+    string path;
+    bool json;
+    chrono::milliseconds interval;
+    mutex stop_mutex;
+    condition_variable stop_signal;
+    bool stopping = false;
+    thread writer;
+
+    void run() {
+        unique_lock<mutex> lock(stop_mutex);
+        while (!stop_signal.wait_for(lock, interval, [this] { return stopping; })) {
+            lock.unlock();
+            try {
+                write_snapshot();
+            } catch (const exception& e) {
+                // A failed snapshot is retried at the next interval
+                cerr << "Warning: " << e.what() << endl;
+            }
+            lock.lock();
+        }
+    }
+
+    void write_snapshot() {
+        const vector<StageSnapshot> stages = snapshot_metrics();
+        const string text = json ? format_metrics_json(stages, metric_ticks_per_second())
+                                 : format_metrics_prometheus(stages, metric_ticks_per_second());
+        const string temporary = path + ".tmp";
+        {
+            UniqueFd out(open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+            if (out.get() < 0) {
+                throw system_error_for(temporary);
+            }
+            write_fully(out.get(), text.data(), text.size(), temporary);
+        }
+        if (rename(temporary.c_str(), path.c_str()) != 0) {
+            throw system_error_for(path);
+        }
+    }
+};
 
-    // Apply Quantum-Inspired Transformation
-    word = quantum_inspired_transform(word);
+s. C ABI: The Pipeline as a Shared Library
 
-    // Final Reflection with REFLECTOR_FFF (actual reflection)
-    uint16_t word_before = word;
-    word = reflect(word, REFLECTOR_FFF);
-    cout << "\nFinal Reflection with REFLECTOR_FFF: " << bitset<16>(word_before) 
-         << " -> " << bitset<16>(word) << " (" << hex << word << dec << ")\n";
+Built with -DONEGOD_LIBRARY as a shared object, this file becomes libonegod.so: main is left out and the extern "C" functions below, taking only integers and pointers, are the whole interface, so C, Python's ctypes or anything else with a C foreign-function interface can call the batch pipeline directly. Exceptions never cross the boundary. A function that can fail returns ONEGOD_OK or ONEGOD_ERROR (a constructor returns NULL) and leaves a message for onegod_last_error on the calling thread. A handle owns a parsed configuration with its compiled pipeline and, in cipher mode, the inverse. Transforming only reads the handle, so one handle serves any number of threads at once; the setters must not run alongside them. Buffers stay the caller's: in and out hold count words each, out may be in, and nothing is copied or kept after the call returns. in[i] is measured as word first_index + i of the stream, exactly as in snake_transformation_pipeline_batch.
 
-    cout << "=== Transformation Complete ===\n";
-    return word;
+// Exported from the shared object even when it is built with -fvisibility=hidden
+#define ONEGOD_API extern "C" __attribute__((visibility("default")))
+
+// Bumped whenever a signature above changes
+constexpr int ONEGOD_ABI_VERSION = 1;
+constexpr int ONEGOD_OK = 0;
+constexpr int ONEGOD_ERROR = -1;
+
+struct onegod_pipeline {
+    PipelineConfig config;
+    CompiledPipeline forward;
+    CompiledPipeline inverse;   // Cipher mode only
+
+    explicit onegod_pipeline(PipelineConfig parsed) : config(move(parsed)) { compile(); }
+
+    void compile() {
+        forward = compile_pipeline(config);
+        if (config.mode == PipelineMode::CIPHER) {
+            inverse = compile_inverse_pipeline(config);
+        }
+    }
+};
+
+string& abi_error() {
+    thread_local string message;
+    return message;
 }
 
-l. Visualization Function: Numbers as Bit Pattern Images
+// Run 'body', turning any exception into ONEGOD_ERROR and a message for onegod_last_error
+template <typename Body>
+int abi_call(Body body) {
+    try {
+        body();
+        return ONEGOD_OK;
+    } catch (const exception& e) {
+        abi_error() = e.what();
+    } catch (...) {
+        abi_error() = "unknown error";
+    }
+    return ONEGOD_ERROR;
+}
 
-void visualize_bit_pattern(uint16_t word, const string& title = "Bit Pattern") {
-    // Create a 4x4 matrix from the 16 bits
-    vector<vector<int>> matrix(4, vector<int>(4, 0));
-    for(int i = 0; i < 16; ++i) {
-        matrix[i / 4][i % 4] = (word >> i) & 1;
+template <typename Make>
+onegod_pipeline* abi_make(Make make) {
+    onegod_pipeline* made = nullptr;
+    abi_call([&] { made = new onegod_pipeline(make()); });
+    return made;
+}
+
+template <typename Pipeline>
+Pipeline& abi_handle(Pipeline* pipeline, const char* function) {
+    if (pipeline == nullptr) {
+        throw invalid_argument(string(function) + ": the pipeline handle is NULL");
     }
+    return *pipeline;
+}
 
-    // Display the matrix as a simple text-based visualization
-    cout << "\n=== " << title << " ===\n";
-    for(const auto& row : matrix) {
-        for(auto bit : row) {
-            cout << (bit ? "█ " : "░ ");
-        }
-        cout << "\n";
+void abi_check_buffers(const uint16_t* in, const uint16_t* out, size_t count, const char* function) {
+    if (count > 0 && (in == nullptr || out == nullptr)) {
+        throw invalid_argument(string(function) + ": a buffer is NULL");
     }
-    cout << "=== End of " << title << " ===\n";
 }
 
-Note: For a more graphical visualization, consider integrating with graphics libraries or exporting the matrix to an image format.
+ONEGOD_API int onegod_abi_version() {
+    return ONEGOD_ABI_VERSION;
+}
 
-m. Define the Snake Communication Verification Function
+// The message of the calling thread's last failed call; valid until its next call
+ONEGOD_API const char* onegod_last_error() {
+    return abi_error().c_str();
+}
 
-We’ll simulate both snakes within the same program by having Snake A send messages to Snake B, and vice versa. The verification ensures that the transformations are correctly applied and responses are as expected.
+ONEGOD_API onegod_pipeline* onegod_pipeline_default() {
+    return abi_make([] { return DEFAULT_PIPELINE; });
+}
 
-// Simulate Snake B's behavior
-string snakeB_response(const string& message) {
-    // For simplicity, Snake B applies the same transformation pipeline
-    // to the received message's numerical representation.
+ONEGOD_API onegod_pipeline* onegod_pipeline_from_spec(const char* text) {
+    return abi_make([text] {
+        if (text == nullptr) {
+            throw invalid_argument("onegod_pipeline_from_spec: the spec text is NULL");
+        }
+        istringstream in(text);
+        return parse_pipeline_spec(in, "spec");
+    });
+}
 
-    // Convert hex string to integer
-    uint16_t word;
-    stringstream ss;
-    ss << hex << message;
-    ss >> word;
+ONEGOD_API onegod_pipeline* onegod_pipeline_load(const char* path) {
+    return abi_make([path] {
+        if (path == nullptr) {
+            throw invalid_argument("onegod_pipeline_load: the path is NULL");
+        }
+        return load_pipeline_spec(path);
+    });
+}
 
-    // Apply transformation pipeline
-    uint16_t transformed_word = snake_transformation_pipeline(word);
+ONEGOD_API void onegod_pipeline_free(onegod_pipeline* pipeline) {
+    delete pipeline;
+}
 
-    // Convert back to hex string
-    stringstream ss_out;
-    ss_out << hex << setw(4) << setfill('0') << transformed_word;
-    return ss_out.str();
+// 0 for a NULL handle
+ONEGOD_API uint64_t onegod_pipeline_seed(const onegod_pipeline* pipeline) {
+    return pipeline != nullptr ? pipeline->config.seed : 0;
 }
 
-// Simulate Snake A's behavior (optional, can mirror Snake B)
-string snakeA_response(const string& message) {
-    // Similar to Snake B, or implement specific behavior
-    // Here, we assume Snake A also applies the transformation
-    uint16_t word;
-    stringstream ss;
-    ss << hex << message;
-    ss >> word;
+// The seed only keys the quantum stage, so nothing is recompiled
+ONEGOD_API int onegod_pipeline_set_seed(onegod_pipeline* pipeline, uint64_t seed) {
+    return abi_call([&] {
+        onegod_pipeline& handle = abi_handle(pipeline, "onegod_pipeline_set_seed");
+        handle.config.seed = handle.forward.seed = handle.inverse.seed = seed;
+    });
+}
 
-    uint16_t transformed_word = snake_transformation_pipeline(word);
+// Nonzero 'cipher' selects cipher mode, as --cipher does; zero the quantum measurement
+ONEGOD_API int onegod_pipeline_set_cipher(onegod_pipeline* pipeline, int cipher) {
+    return abi_call([&] {
+        onegod_pipeline& handle = abi_handle(pipeline, "onegod_pipeline_set_cipher");
+        handle.config.mode = cipher ? PipelineMode::CIPHER : PipelineMode::QUANTUM;
+        handle.compile();
+    });
+}
 
-    stringstream ss_out;
-    ss_out << hex << setw(4) << setfill('0') << transformed_word;
-    return ss_out.str();
+ONEGOD_API int onegod_transform_batch(const onegod_pipeline* pipeline, const uint16_t* in, uint16_t* out, size_t count,
+                                      uint64_t first_index, uint64_t stream) {
+    return abi_call([&] {
+        const onegod_pipeline& handle = abi_handle(pipeline, "onegod_transform_batch");
+        abi_check_buffers(in, out, count, "onegod_transform_batch");
+        snake_transformation_pipeline_batch(handle.forward, span<const uint16_t>(in, count), span<uint16_t>(out, count),
+                                            first_index, stream);
+    });
 }
 
-// Verification function
-void verifySnakeCommunication(const vector<string>& outputs, const vector<string>& expectedA, const vector<string>& expectedB) {
-    for (size_t i = 0; i < outputs.size(); i++) {
-        cout << "\n--- Step " << i + 1 << " ---\n";
-        // Snake A sends output[i] to Snake B
-        string messageA = outputs[i];
-        cout << "Snake A sends to Snake B: " << messageA << endl;
-        cerr << "Sent (A Snake): " << messageA << endl;
+// Undo onegod_transform_batch with the same first_index and stream; cipher mode only
+ONEGOD_API int onegod_inverse_batch(const onegod_pipeline* pipeline, const uint16_t* in, uint16_t* out, size_t count,
+                                    uint64_t first_index, uint64_t stream) {
+    return abi_call([&] {
+        const onegod_pipeline& handle = abi_handle(pipeline, "onegod_inverse_batch");
+        if (handle.config.mode != PipelineMode::CIPHER) {
+            throw invalid_argument("onegod_inverse_batch: only a cipher-mode pipeline can be inverted");
+        }
+        abi_check_buffers(in, out, count, "onegod_inverse_batch");
+        snake_transformation_pipeline_batch(handle.inverse, span<const uint16_t>(in, count), span<uint16_t>(out, count),
+                                            first_index, stream);
+    });
+}
 
-        // Snake B processes and responds
-        string responseB = snakeB_response(messageA);
-        cout << "Snake B responds with: " << responseB << endl;
-        cerr << "Received (B Snake): " << responseB << endl;
+A C caller declares the interface as:
+
+typedef struct onegod_pipeline onegod_pipeline;
+int onegod_abi_version(void);
+const char* onegod_last_error(void);
+onegod_pipeline* onegod_pipeline_default(void);
+onegod_pipeline* onegod_pipeline_from_spec(const char* text);   /* the text of a spec file */
+onegod_pipeline* onegod_pipeline_load(const char* path);
+void onegod_pipeline_free(onegod_pipeline* pipeline);
+uint64_t onegod_pipeline_seed(const onegod_pipeline* pipeline);
+int onegod_pipeline_set_seed(onegod_pipeline* pipeline, uint64_t seed);
+int onegod_pipeline_set_cipher(onegod_pipeline* pipeline, int cipher);
+int onegod_transform_batch(const onegod_pipeline* pipeline, const uint16_t* in, uint16_t* out, size_t count,
+                           uint64_t first_index, uint64_t stream);
+int onegod_inverse_batch(const onegod_pipeline* pipeline, const uint16_t* in, uint16_t* out, size_t count,
+                         uint64_t first_index, uint64_t stream);
+
+Python reaches the library through ctypes and passes numpy arrays by their data pointers, so a batch goes from a numpy buffer to the vector kernels and back with no copy and no per-word Python; ctypes also releases the GIL for the call, so Python threads can transform different buffers at once. The notes to ONEGOD.py carry onegod_native.py, a binding with a class around the handle; at its simplest:
+
+import ctypes
+import numpy as np
+
+lib = ctypes.CDLL("./libonegod.so")
+lib.onegod_pipeline_default.restype = ctypes.c_void_p
+lib.onegod_transform_batch.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t,
+                                       ctypes.c_uint64, ctypes.c_uint64]
+
+pipeline = lib.onegod_pipeline_default()
+words = np.arange(65536, dtype=np.uint16)
+answers = np.empty_like(words)
+lib.onegod_transform_batch(pipeline, words.ctypes.data, answers.ctypes.data, words.size, 0, 0xB)
+
+4. Main Execution: Running the Game of Two Snakes
+
+// Options accepted by main
+struct CommandLine {
+    string spec_path;                          // --spec <file>: pipeline spec replacing the default
+    string seed;                               // --seed <n>: quantum seed replacing the pipeline's
+    bool cipher = false;                       // --cipher: keystream XOR instead of measurement (invertible)
+    bool decrypt = false;                      // --decrypt: run the inverse pipeline (--stream)
+    string threads;                            // --threads <n>: worker threads for the parallel modes
+    bool stream = false;                       // --stream [file]: transform a stream of words (stdin by default)
+    string stream_path;
+    StreamFormat format = StreamFormat::HEX;   // --binary: the stream holds little-endian 16-bit words
+    string encrypt_input;                      // --encrypt-file <file> [output]: encrypt in place or into output
+    string encrypt_output;
+    string decrypt_input;                      // --decrypt-file <file> [output]: undo --encrypt-file
+    string decrypt_output;
+    string golden_path;                        // --verify <golden>: check a golden file on the pool
+    bool sweep = false;                        // --sweep: all 65536 inputs against the reference pipeline
+    bool bench = false;                        // --bench [csv|json]: time every stage, CSV by default
+    BenchmarkOptions bench_options;            // --bench-max <bytes>, --bench-reps <n>, --bench-filter <text>
+    string image_input;                        // --image <file> <image>: draw the file's transformed words
+    string image_output;
+    ImageColoring coloring = ImageColoring::GRAY;   // --coloring gray|color|bitstate
+    size_t image_tiles = 0;                    // --image-width <tiles>: tiles per row (up to 256 by default)
+    string emirp_limit;                        // --emirps <limit>: list the emirps up to limit (cached)
+    string emirp_crowns;                       // --emirp-crowns <count> [limit]: crowns from emirps, replacing the pipeline's
+    string emirp_crowns_limit = "1000000000";
+    string store_path;                         // --store <file>: record --stream results in a result store
+    string lookup;                             // --lookup <word>: print the stored results for an input
+    bool cycles = false;                       // --cycles [16|32|64|128]: cycle structure of the deterministic pipeline
+    CycleOptions cycle_options;                // --orbit <word>, --cycle-samples <n>, --cycle-steps <n>
+    bool channel = false;                      // --channel [words]: Snake B in a child process over shared memory
+    ChannelOptions channel_options;            // --channel-batch <words>
+    bool sessions = false;                     // --sessions [count]: many conversations at once on the session engine
+    SessionOptions session_options;            // --session-exchanges <n>
+    bool avalanche = false;                    // --avalanche: avalanche matrix and output bit bias over all inputs
+    string metrics_path;                       // --metrics <file>: stage metrics snapshots, rewritten every interval
+    bool metrics_json = false;                 // --metrics-format prometheus|json
+    chrono::milliseconds metrics_interval{ 1000 };   // --metrics-interval <ms>
+};
 
-        // Verify B Snake's response
-        if (responseB != expectedB[i]) {
-            cerr << "Error: Verification failed for B Snake at step " << i + 1 << endl;
-            cerr << "Expected (B Snake): " << expectedB[i] << ", but got: " << responseB << endl;
-            return;
+CommandLine parse_command_line(int argc, char* argv[]) {
+    CommandLine options;
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) {
+                throw invalid_argument(arg + " needs a value");
+            }
+            return argv[++i];
+        };
+        if (arg == "--spec") {
+            options.spec_path = value();
+        } else if (arg == "--seed") {
+            options.seed = value();
+        } else if (arg == "--cipher") {
+            options.cipher = true;
+        } else if (arg == "--decrypt") {
+            options.decrypt = true;
+        } else if (arg == "--threads") {
+            options.threads = value();
+        } else if (arg == "--stream") {
+            options.stream = true;
+            if (i + 1 < argc && string_view(argv[i + 1]).substr(0, 2) != "--") {
+                options.stream_path = argv[++i];
+            }
+        } else if (arg == "--encrypt-file") {
+            options.encrypt_input = value();
+            if (i + 1 < argc && string_view(argv[i + 1]).substr(0, 2) != "--") {
+                options.encrypt_output = argv[++i];
+            }
+        } else if (arg == "--decrypt-file") {
+            options.decrypt_input = value();
+            if (i + 1 < argc && string_view(argv[i + 1]).substr(0, 2) != "--") {
+                options.decrypt_output = argv[++i];
+            }
+        } else if (arg == "--verify") {
+            options.golden_path = value();
+        } else if (arg == "--sweep") {
+            options.sweep = true;
+        } else if (arg == "--bench") {
+            options.bench = true;
+            if (i + 1 < argc && string_view(argv[i + 1]).substr(0, 2) != "--") {
+                const string format = argv[++i];
+                if (format != "csv" && format != "json") {
+                    throw invalid_argument("--bench: expected csv or json, got '" + format + "'");
+                }
+                options.bench_options.json = format == "json";
+            }
+        } else if (arg == "--bench-max") {
+            options.bench_options.max_bytes = parse_byte_count(value(), "--bench-max");
+        } else if (arg == "--bench-reps") {
+            const string reps = value();
+            auto [end, error] = from_chars(reps.data(), reps.data() + reps.size(), options.bench_options.repetitions);
+            if (error != errc() || end != reps.data() + reps.size() || options.bench_options.repetitions == 0) {
+                throw invalid_argument("--bench-reps: expected a positive count, got '" + reps + "'");
+            }
+        } else if (arg == "--bench-filter") {
+            options.bench_options.filter = value();
+        } else if (arg == "--cycles") {
+            options.cycles = true;
+            if (i + 1 < argc && string_view(argv[i + 1]).substr(0, 2) != "--") {
+                const string bits = argv[++i];
+                if (bits != "16" && bits != "32" && bits != "64" && bits != "128") {
+                    throw invalid_argument("--cycles: expected a word width of 16, 32, 64 or 128, got '" + bits + "'");
+                }
+                options.cycle_options.bits = stoi(bits);
+            }
+        } else if (arg == "--orbit") {
+            options.cycles = true;
+            options.cycle_options.orbit_start = value();
+        } else if (arg == "--cycle-samples" || arg == "--cycle-steps") {
+            const string count = value();
+            uint64_t parsed = 0;
+            auto [end, error] = from_chars(count.data(), count.data() + count.size(), parsed);
+            if (error != errc() || end != count.data() + count.size() || parsed == 0) {
+                throw invalid_argument(arg + ": expected a positive count, got '" + count + "'");
+            }
+            (arg == "--cycle-samples" ? options.cycle_options.samples : options.cycle_options.step_limit) = parsed;
+        } else if (arg == "--channel" || arg == "--channel-batch") {
+            options.channel = true;
+            const bool words = arg == "--channel";
+            if (words && (i + 1 >= argc || string_view(argv[i + 1]).substr(0, 2) == "--")) {
+                continue;
+            }
+            const string count = value();
+            uint64_t parsed = 0;
+            auto [end, error] = from_chars(count.data(), count.data() + count.size(), parsed);
+            if (error != errc() || end != count.data() + count.size() || parsed == 0 || (!words && parsed > (1 << 16))) {
+                throw invalid_argument(arg + ": expected a positive count" + (words ? "" : " up to 65536") + ", got '" + count + "'");
+            }
+            (words ? options.channel_options.messages : options.channel_options.batch) = parsed;
+        } else if (arg == "--sessions" || arg == "--session-exchanges") {
+            options.sessions = true;
+            const bool count_of_sessions = arg == "--sessions";
+            if (count_of_sessions && (i + 1 >= argc || string_view(argv[i + 1]).substr(0, 2) == "--")) {
+                continue;
+            }
+            const string count = value();
+            uint32_t parsed = 0;
+            auto [end, error] = from_chars(count.data(), count.data() + count.size(), parsed);
+            if (error != errc() || end != count.data() + count.size() || parsed == 0) {
+                throw invalid_argument(arg + ": expected a positive count, got '" + count + "'");
+            }
+            if (count_of_sessions) {
+                options.session_options.sessions = parsed;
+            } else {
+                options.session_options.exchanges = parsed;
+            }
+        } else if (arg == "--metrics") {
+            options.metrics_path = value();
+        } else if (arg == "--metrics-format") {
+            const string format = value();
+            if (format != "prometheus" && format != "json") {
+                throw invalid_argument("--metrics-format: expected prometheus or json, got '" + format + "'");
+            }
+            options.metrics_json = format == "json";
+        } else if (arg == "--metrics-interval") {
+            const string interval = value();
+            unsigned milliseconds = 0;
+            auto [end, error] = from_chars(interval.data(), interval.data() + interval.size(), milliseconds);
+            if (error != errc() || end != interval.data() + interval.size() || milliseconds == 0) {
+                throw invalid_argument("--metrics-interval: expected a positive number of milliseconds, got '" + interval + "'");
+            }
+            options.metrics_interval = chrono::milliseconds(milliseconds);
+        } else if (arg == "--avalanche") {
+            options.avalanche = true;
+        } else if (arg == "--store") {
+            options.store_path = value();
+        } else if (arg == "--lookup") {
+            options.lookup = value();
+        } else if (arg == "--emirps") {
+            options.emirp_limit = value();
+        } else if (arg == "--emirp-crowns") {
+            options.emirp_crowns = value();
+            if (i + 1 < argc && string_view(argv[i + 1]).substr(0, 2) != "--") {
+                options.emirp_crowns_limit = argv[++i];
+            }
+        } else if (arg == "--image") {
+            options.image_input = value();
+            options.image_output = value();
+        } else if (arg == "--coloring") {
+            options.coloring = parse_image_coloring(value());
+        } else if (arg == "--image-width") {
+            const string tiles = value();
+            auto [end, error] = from_chars(tiles.data(), tiles.data() + tiles.size(), options.image_tiles);
+            if (error != errc() || end != tiles.data() + tiles.size() || options.image_tiles == 0 || options.image_tiles > (1 << 20)) {
+                throw invalid_argument("--image-width: expected a tile count from 1 to 1048576, got '" + tiles + "'");
+            }
+        } else if (arg == "--binary") {
+            options.format = StreamFormat::BINARY;
+        } else {
+            throw invalid_argument("unknown option '" + arg + "'");
         }
+    }
+    return options;
+}
 
-        cerr << "Step " << i + 1 << ": B Snake's response verified successfully." << endl;
+// The shared library (see C ABI) has no main
+#ifndef ONEGOD_LIBRARY
+int main(int argc, char* argv[]) {
+    // Stage metrics: snapshots from a side thread for as long as main runs, and one more on the way out
+    unique_ptr<MetricsWriter> metrics_writer;
+    try {
+        const CommandLine options = parse_command_line(argc, argv);
+        if (!options.spec_path.empty()) {
+            active_pipeline() = load_pipeline_spec(options.spec_path);
+        }
+        if (!options.seed.empty()) {
+            active_pipeline().seed = parse_seed(options.seed, "--seed");
+        }
+        if (options.cipher) {
+            active_pipeline().mode = PipelineMode::CIPHER;
+        }
+        if (!options.threads.empty()) {
+            requested_worker_threads() = parse_thread_count(options.threads, "--threads");
+        }
+        if (!options.emirp_crowns.empty()) {
+            active_pipeline().crowned_primes = emirp_crowned_primes(parse_spec_number32(options.emirp_crowns, "--emirp-crowns"),
+                                                                    parse_spec_number32(options.emirp_crowns_limit, "--emirp-crowns"));
+        }
 
-        // Snake A expects expectedA[i] from B Snake
-        string messageExpectedA = expectedA[i];
-        cout << "Snake A expects to send: " << messageExpectedA << endl;
-        cerr << "Sent (A Snake expected): " << messageExpectedA << endl;
+        if (!options.metrics_path.empty()) {
+            metrics_writer = make_unique<MetricsWriter>(options.metrics_path, options.metrics_json, options.metrics_interval);
+        }
 
-        // Snake B processes and responds
-        string responseA = snakeA_response(messageExpectedA);
-        cout << "Snake A receives: " << responseA << endl;
-        cerr << "Received (A Snake): " << responseA << endl;
+        // Emirp listing: one per line on stdout
+        if (!options.emirp_limit.empty()) {
+            const vector<uint32_t> emirps = emirps_up_to(parse_spec_number32(options.emirp_limit, "--emirps"), worker_pool());
+            string text;
+            for (uint32_t emirp : emirps) {
+                text += to_string(emirp);
+                text += '\n';
+            }
+            write_fully(STDOUT_FILENO, text.data(), text.size(), "stdout");
+            return 0;
+        }
 
-        // Verify A Snake's response
-        if (responseA != outputs[i]) {
-            cerr << "Error: Verification failed for A Snake at step " << i + 1 << endl;
-            cerr << "Expected (A Snake): " << outputs[i] << ", but got: " << responseA << endl;
-            return;
+        unique_ptr<ResultStore> store;
+        if (!options.store_path.empty()) {
+            store = make_unique<ResultStore>(options.store_path);
+            if (store->recovered() > 0) {
+                cerr << options.store_path << ": recovered " << store->recovered() << " records written after the last sync" << endl;
+            }
         }
 
-        cerr << "Step " << i + 1 << ": A Snake's response verified successfully." << endl;
-    }
+        // Lookup mode: stored results for one input under the active pipeline, as golden-file lines
+        if (!options.lookup.empty()) {
+            uint16_t input = 0;
+            if (!store || !parse_hex_word(string_view(options.lookup), input)) {
+                throw invalid_argument("--lookup needs --store <file> and a word of 1-4 hex digits");
+            }
+            char word[4];
+            for (const StoredResult& result : store->find(active_compiled_pipeline().config_hash, input)) {
+                format_hex_word(result.output, word);
+                cout << options.lookup << " " << string_view(word, 4) << " " << result.index << "  # seed " << result.seed
+                     << " stream " << result.stream << "\n";
+            }
+            return 0;
+        }
 
-    cout << "\nAll steps verified successfully for both snakes!\n";
-}
+        // Streaming mode: results go to stdout and nothing else runs
+        if (options.stream) {
+            UniqueFd input = open_input(options.stream_path);
+            const string source = options.stream_path.empty() || options.stream_path == "-" ? "stdin" : options.stream_path;
+            StreamOptions stream_options;
+            stream_options.format = options.format;
+            const CompiledPipeline& pipeline = options.decrypt ? active_compiled_inverse() : active_compiled_pipeline();
+            if (store) {
+                stream_options.record = [&](span<const uint16_t> inputs, span<const uint16_t> outputs, uint64_t first_index) {
+                    store->append(pipeline.config_hash, pipeline.seed, stream_options.stream, first_index, inputs, outputs);
+                };
+            }
+            StreamStats stats = run_stream(input.get(), STDOUT_FILENO, source, pipeline, stream_options, worker_pool());
+            if constexpr (DEFAULT_TRACE_LEVEL != TraceLevel::Silent) {
+                cerr << "Streamed " << stats.words << " words in " << stats.chunks << " chunks on "
+                     << worker_pool().size() << " threads" << endl;
+            }
+            return 0;
+        }
+
+        // Cycle mode: the cycle structure, or one orbit, on stdout
+        if (options.cycles) {
+            CycleOptions cycle_options = options.cycle_options;
+            cycle_options.seed = active_pipeline().seed;
+            analyze_cycles(cout, cycle_options, worker_pool());
+            return 0;
+        }
+
+        // Channel mode: the two snakes as processes, timed round trip by round trip
+        if (options.channel) {
+            const ChannelStats stats = run_channel(options.channel_options, active_compiled_pipeline());
+            print_channel_stats(cout, stats);
+            return stats.mismatched == 0 ? 0 : 1;
+        }
+
+        // Session mode: many conversations multiplexed on the pool
+        if (options.sessions) {
+            const SessionReport report = run_sessions(options.session_options, active_compiled_pipeline(), worker_pool());
+            print_session_report(cout, report);
+            return report.mismatched == 0 ? 0 : 1;
+        }
+
+        // Avalanche mode: output quality statistics on stdout
+        if (options.avalanche) {
+            print_avalanche_stats(cout, avalanche_stats(active_compiled_pipeline(), SNAKE_B_STREAM, worker_pool()));
+            return 0;
+        }
+
+        // Benchmark mode: results go to stdout
+        if (options.bench) {
+            print_benchmark_results(cout, run_benchmarks(options.bench_options, worker_pool()), options.bench_options.json);
+            return 0;
+        }
+
+        // Image mode: draw a file's transformed words and exit
+        if (!options.image_input.empty()) {
+            ImageStats stats = render_bit_image(options.image_input, options.image_output, options.coloring, options.image_tiles,
+                                                active_compiled_pipeline(), SNAKE_B_STREAM, worker_pool());
+            if constexpr (DEFAULT_TRACE_LEVEL != TraceLevel::Silent) {
+                cerr << "Drew " << stats.words << " words as a " << stats.width << "x" << stats.height << " image on "
+                     << worker_pool().size() << " threads" << endl;
+            }
+            return 0;
+        }
+
+        // Verification modes: exit status 1 when anything mismatches
+        if (options.sweep || !options.golden_path.empty()) {
+            bool passed = true;
+            if (!options.golden_path.empty()) {
+                vector<GoldenVector> vectors = load_golden_file(options.golden_path, worker_pool());
+                VerificationReport report = verify_golden(vectors, active_compiled_pipeline(), SNAKE_B_STREAM, worker_pool());
+                print_report(cout, options.golden_path, report);
+                passed = passed && report.passed();
+            }
+            if (options.sweep) {
+                VerificationReport report = sweep_against_reference(active_pipeline(), active_compiled_pipeline(),
+                                                                    SNAKE_B_STREAM, worker_pool());
+                print_report(cout, "sweep", report);
+                passed = passed && report.passed();
+            }
+            return passed ? 0 : 1;
+        }
 
-n. Main Execution: Running the Game of Two Snakes
+        // File modes: encrypt or decrypt one file and exit
+        if (!options.encrypt_input.empty()) {
+            FileCipherStats stats = encrypt_file(options.encrypt_input, options.encrypt_output, active_compiled_pipeline(),
+                                                 SNAKE_B_STREAM, worker_pool());
+            if constexpr (DEFAULT_TRACE_LEVEL != TraceLevel::Silent) {
+                cerr << "Encrypted " << stats.bytes << " bytes (" << stats.words << " words) on "
+                     << worker_pool().size() << " threads" << endl;
+            }
+            return 0;
+        }
+        if (!options.decrypt_input.empty()) {
+            FileCipherStats stats = decrypt_file(options.decrypt_input, options.decrypt_output, active_compiled_inverse(),
+                                                 SNAKE_B_STREAM, worker_pool());
+            if constexpr (DEFAULT_TRACE_LEVEL != TraceLevel::Silent) {
+                cerr << "Decrypted " << stats.bytes << " bytes (" << stats.words << " words) on "
+                     << worker_pool().size() << " threads" << endl;
+            }
+            return 0;
+        }
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
 
-int main() {
     // Define the size (not used in this simulation, but kept for compatibility)
     int size;
     cin >> size; // Read size from input
@@ -369,13 +6011,23 @@ int main() {
     // Define expectedA (mirror of outputs)
     vector<string> expectedA = outputs; // Snake A expects to send the same outputs
 
-    // Verify Snake Communication
-    verifySnakeCommunication(outputs, expectedA, expectedB);
+    // Verify Snake Communication; the expected responses are 32-bit words. They are placeholders, and Snake A's
+    // answers come from the quantum stage rather than from the message, so the mismatches are reported but do
+    // not fail the demo. --verify and --sweep are the checks whose exit status means something.
+    try {
+        if (!verifySnakeCommunication<uint32_t>(outputs, expectedA, expectedB)) {
+            cerr << "(the expected responses are placeholders; use --verify or --sweep to check the pipeline)" << endl;
+        }
+    } catch (const invalid_argument& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
 
     return 0;
 }
+#endif
 
-3. Understanding the Components and Flow
+5. Understanding the Components and Flow
 	1.	Snake A and Snake B:
 	•	Snake A sends a message (hex string) to Snake B.
 	•	Snake B processes the message using the snakeB_response function, which applies the transformation pipeline and returns a transformed hex string.
@@ -392,8 +6044,54 @@ int main() {
 	•	Simulates a quantum superposition by setting each bit’s probability to 0.5 and measuring it to introduce randomness.
 	5.	Visualization:
 	•	Represents the final bit pattern as a simple text-based visualization using block characters.
-
-4. Example Execution and Output
+	6.	Pipeline Compiler:
+	•	Folds the transformers and crowns of weights into one GF(2) affine map, and the final reflection into another, each backed by a shared 65536-entry lookup table.
+	7.	Batch Pipeline:
+	•	snake_transformation_pipeline_batch runs the folded maps over spans of words with AVX-512, AVX2 or SSE2 kernels picked at runtime, falling back to the lookup tables.
+	8.	Trace Policy:
+	•	The transformation functions take a Silent, Summary or Full trace level as a template parameter; traced steps are buffered per thread and written to ONEGOD.trace instead of cout. Builds default to Silent.
+	9.	Transformer Bytecode and Spec Files:
+	•	Transformers store named operations (rotl, rotr, xor, not, reflect, crown) that an interpreter dispatches on, fusing neighbouring rotations and XORs; a whole pipeline can be loaded from a text spec with --spec.
+	10.	Hex Codec:
+	•	Messages are parsed and formatted without stringstreams and malformed messages are rejected; SnakeResponder answers whole batches through SSSE3 block codecs into one reusable buffer.
+	11.	Reproducible Quantum Measurements:
+	•	Measurements come from a counter-based generator keyed by the pipeline seed, a per-snake stream and the message index, so any thread can reproduce any message; the seed is set with the spec seed keyword or --seed.
+	12.	Streaming Engine:
+	•	--stream reads hex lines or little-endian binary words from stdin or a file in large chunks, transforms the chunks on a work-stealing thread pool and writes the answers in input order, keeping only a fixed window of chunks in memory.
+	13.	File Encryption:
+	•	--encrypt-file maps a file and transforms it as little-endian 16-bit words in parallel ranges, in place or into a second mapped file, and only in cipher mode, since nothing could decrypt the quantum mode's output; an odd trailing byte is covered by one extra word overlapping the last whole word.
+	14.	Inverse Pipeline and Cipher Mode:
+	•	In cipher mode the quantum stage becomes an XOR with the seeded measurement bits, so every stage can be undone: snake_inverse_pipeline runs the inverse operations in reverse, and compile_inverse_pipeline inverts the folded GF(2) matrices so --decrypt and --decrypt-file run on the same vector kernels as encryption.
+	15.	Word Widths:
+	•	The five operations, transformers, crowns of weights and the pipeline are templates over 16-, 32-, 64- and 128-bit words; keys and reflectors widen by repeating their 16-bit pattern, and the snakes in main exchange 32-bit words to match the expected responses.
+	16.	Verification Engine:
+	•	--verify checks golden files of (input, expected) pairs in parallel and --sweep compares all 65536 inputs against a reference that interprets every operation as written; both collect every mismatch into one compact report, as verifySnakeCommunication now does for its steps.
+	17.	Benchmark Suite:
+	•	--bench times each primitive, each Transformer, the crown of weights, the quantum stage and the full pipeline (plus its 32-, 64- and 128-bit forms) in scalar, table and batch variants, single-threaded and on the pool, from L1-sized to multi-gigabyte buffers, and reports mean, spread and best ns per word and GB/s as CSV or JSON.
+	18.	Bit Pattern Images:
+	•	--image renders a whole file of transformed words as 4x4 tiles of one PGM or PPM image, in gray, colored by Color against each word's input, or by the BitState of each pair of bits, filling a mapped output file from the pool through per-row lookup tables.
+	19.	GF(2^16) Multiplication:
+	•	gfmul multiplies each 16-bit lane by a nonzero constant modulo x^16 + x^12 + x^3 + x + 1, with PCLMULQDQ and Barrett reduction where available and log/antilog tables elsewhere; being linear over GF(2) it folds into the affine maps and vector kernels like any other operation, and its inverse multiplies by the inverse constant.
+	20.	Emirp Sieve:
+	•	A parallel, segmented, odd-only bit sieve finds the emirps up to 2^32 - 1, checking reversals past the limit with deterministic Miller-Rabin; the list is cached as variable-length gaps in ~/.cache/onegod/emirps, and emirp_crowned_primes (--emirp-crowns, or emirp_crowns in a spec) turns it into crowns of weights, with primes widened to 32 bits.
+	21.	Result Store:
+	•	An append-only, memory-mapped log of fixed-width, checksummed records (pipeline hash, seed, stream, index, input, output), appended in parallel batches straight from the pipeline or the stream, indexed by input, and recovered on open by keeping the records up to the first that fails its checksum.
+	22.	Cycle Analysis:
+	•	The cycle structure of the pipeline without its quantum stage: fixed points and a histogram of cycle lengths over every 16- or 32-bit word, walked in parallel against a bitset of visited words, sampled for 64- and 128-bit words, and the orbit of any one word.
+	23.	Shared-Memory Channel:
+	•	Snake B in its own process, answering Snake A over two lock-free single-producer, single-consumer rings of words in POSIX shared memory, each side spinning briefly and then sleeping on a futex while it waits, with round-trip latency percentiles and throughput.
+	24.	Session Engine:
+	•	Many snake conversations at once, each a C++20 coroutine of a hundred-odd bytes with its own keys and pipeline, parked on every message; the engine answers all waiting messages in one batch per round through the vector kernels and resumes the conversations on the pool.
+	25.	Avalanche Statistics:
+	•	Every input flipped at each of its 16 bits and run through the batch pipeline, tallied with vector bit counts into a 16x16 avalanche matrix, a histogram of output bits changed per flip and per-output-bit bias, so configurations can be compared by figures rather than by eye.
+	26.	Stage Metrics:
+	•	Always-on per-thread counters, one cache line per stage, for each transformer, the crowned primes, the quantum stage, the snakes' hex codec and the batch pipeline, with one call in 64 timed by the time-stamp counter into latency histograms; a side thread writes the totals as Prometheus text or JSON for a local scraper.
+	27.	Bitsliced Kernels:
+	•	Blocks of 64, 256 or 512 words transposed into sixteen bit-planes, the folded transformers and crowns run as plane renames, inversions and XORs, and transposed back, bit-identical to the other kernels; ONEGOD_KERNEL=bitsliced makes every folded map use them, --sweep checks them against the lookup table, and --bench times them beside the vector kernels.
+	28.	C ABI:
+	•	Built with -DONEGOD_LIBRARY, the file is libonegod.so: opaque pipeline handles from the default configuration or spec text or files, seed and cipher-mode setters, and batch transform and inverse calls on caller-owned uint16_t buffers, with errors as status codes and a per-thread message instead of exceptions; Python calls it through ctypes on numpy arrays without copying.
+
+6. Example Execution and Output
 
 Let’s walk through an example execution of the finalized ONEGOD.cpp script.
 
@@ -466,7 +6164,7 @@ Explanation:
 
 Note: The expected responses (expectedB) in the verifySnakeCommunication function are placeholders. You need to align these expectations based on the actual transformation results.
 
-5. Addressing the Provided Code Snippets and Logs
+7. Addressing the Provided Code Snippets and Logs
 
 You’ve shared extensive code snippets and logs from various test cases and transformations. Here’s how to integrate and address them within ONEGOD.cpp:
 	1.	Emirp Primes:
@@ -485,26 +6183,114 @@ You’ve shared extensive code snippets and logs from various test cases and tra
 	•	Integration: Implement scoring or resonance calculations based on transformation results.
 	•	Example: Define a function that calculates resonance based on the number of set bits or specific patterns.
 
-6. Enhancing the Script: Quantum-Inspired Operators
+8. Enhancing the Script: Quantum-Inspired Operators
 
 To elevate the complexity and security of your transformations, integrating Quantum-Inspired Operators introduces unpredictability akin to quantum superposition.
 
 Note: Quantum computing concepts are abstract and not directly implementable in classical systems. The following is a simplified simulation.
 
-7. Finalizing and Running the Script
+9. Finalizing and Running the Script
 
 Ensure that all components are correctly integrated and that the script compiles without errors.
 
 Compilation Instructions:
 
-Use a C++11 compatible compiler.
+Use a C++20 compatible compiler (GCC or Clang; the vector kernels are selected at runtime on x86-64).
+
+g++ -std=c++20 -O2 -pthread -o ONEGOD ONEGOD.cpp
 
-g++ -std=c++11 -o ONEGOD ONEGOD.cpp
+The trace level defaults to Silent, which compiles tracing out and writes no file. Pass -DONEGOD_TRACE_LEVEL=Summary for one record per transformed word in ONEGOD.trace, or -DONEGOD_TRACE_LEVEL=Full to record every operation; set ONEGOD_TRACE_FILE to choose another trace file.
 
 Running the Script:
 
 ./ONEGOD
 
+To run with another pipeline configuration, pass a spec file (see Pipeline Spec Files):
+
+./ONEGOD --spec my_pipeline.spec
+
+To stream a capture of hex words (one per line) through every core, writing one answer per line in input order:
+
+./ONEGOD --stream capture.hex > answers.hex
+cat capture.hex | ./ONEGOD --stream --threads 8 > answers.hex
+./ONEGOD --stream capture.bin --binary > answers.bin
+
+Lines may hold 1 to 4 digits and end in '\r\n' as well as '\n'; a capture from Windows answers exactly as the same capture with Unix line ends:
+
+diff <(printf 'abc\r\n12\r\nbeef\r\n7\r\n' | ./ONEGOD --stream) <(printf 'abc\n12\nbeef\n7\n' | ./ONEGOD --stream)
+
+To encrypt a file in place, or into a second file, as little-endian 16-bit words (see Memory-Mapped File Encryption for the odd-length rule). The default quantum stage throws its input away, so --encrypt-file refuses to run unless the pipeline is in cipher mode (--cipher, or mode cipher in a spec); use the same seed and mode to decrypt:
+
+./ONEGOD --cipher --seed 42 --encrypt-file data.bin
+./ONEGOD --cipher --seed 42 --encrypt-file data.bin data.enc
+./ONEGOD --cipher --seed 42 --decrypt-file data.enc data.out
+./ONEGOD --cipher --stream answers.hex --decrypt > capture.hex
+
+To check the pipeline against a golden file of "<input> <expected> [index]" lines, or sweep all 65536 inputs against the reference implementation (both run on every core and list every mismatch):
+
+./ONEGOD --stream capture.hex > answers.hex && paste -d ' ' capture.hex answers.hex > golden.txt
+./ONEGOD --verify golden.txt
+./ONEGOD --sweep
+
+To time every stage in its scalar, table and batch forms, on one thread and on the pool, from 4 KiB buffers up to --bench-max (64M by default; suffixes K, M and G), writing CSV or JSON:
+
+./ONEGOD --bench > bench.csv
+./ONEGOD --bench json --bench-max 4G --bench-reps 10 > bench.json
+./ONEGOD --bench --bench-filter pipeline
+
+To draw every transformed word of a file as a 4x4 tile of one image (see Bit Pattern Images):
+
+./ONEGOD --image data.bin data.pgm
+./ONEGOD --image data.bin changes.ppm --coloring color --image-width 512
+./ONEGOD --image data.bin pairs.ppm --coloring bitstate
+
+To list the emirps up to a limit, or take the crowns of weights from them (the first run sieves and writes ~/.cache/onegod/emirps, or $ONEGOD_EMIRP_CACHE; later runs read it):
+
+./ONEGOD --emirps 1000000 > emirps.txt
+./ONEGOD --emirp-crowns 64 1000000000 --sweep
+
+To keep every streamed result in a result store, and look results up by input later (printed as golden-file lines):
+
+./ONEGOD --stream capture.hex --store results.ogs > answers.hex
+./ONEGOD --store results.ogs --lookup 1234
+
+To see the cycle structure of the pipeline without its quantum stage, at 16 bits, 32 bits (a 512 MiB bitset) or sampled at 64, and the orbit of one word:
+
+./ONEGOD --cycles
+./ONEGOD --cycles 32 --threads 8
+./ONEGOD --cycles 64 --cycle-samples 1024 --cycle-steps 100000000
+./ONEGOD --orbit 1234
+
+To time the two snakes as separate processes talking through shared memory, 64 words per round trip by default:
+
+./ONEGOD --channel
+./ONEGOD --channel 100000000 --channel-batch 256
+
+To hold many conversations at once on the session engine, 10000 of 100 exchanges by default:
+
+./ONEGOD --sessions
+./ONEGOD --sessions 50000 --session-exchanges 20 --threads 4
+
+To measure how the pipeline mixes its input, and compare configurations:
+
+./ONEGOD --avalanche
+./ONEGOD --spec candidate.spec --cipher --avalanche
+
+To expose stage metrics to a local scraper while any mode runs (rewritten every second, and once more at exit):
+
+./ONEGOD --metrics onegod.prom --stream capture.hex > answers.hex
+./ONEGOD --metrics onegod.json --metrics-format json --metrics-interval 250 --sessions
+
+To run every folded map through the bitsliced kernels instead of the vector kernels, or to compare the two:
+
+ONEGOD_KERNEL=bitsliced ./ONEGOD --sweep
+./ONEGOD --bench --bench-filter bitsliced --bench-max 1M
+
+To build the shared library instead of the program, and transform through it from Python (onegod_native.py is in the notes to ONEGOD.py):
+
+g++ -std=c++20 -O2 -pthread -shared -fPIC -fvisibility=hidden -DONEGOD_LIBRARY -o libonegod.so ONEGOD.cpp
+python3 onegod_native.py
+
 Sample Interaction:
 
 5
@@ -567,7 +6353,7 @@ Explanation:
 	5.	Snake A sends back 0001, expecting to receive FFFF again.
 	6.	Snake A verifies the response, completing the communication verification.
 
-8. Conclusion and Next Steps
+10. Conclusion and Next Steps
 
 Your ONEGOD.cpp script now encapsulates the intricate interplay of bit manipulation, prime transformations, and symbolic representations that define the “Game of Two Snakes”. Here’s how to proceed:
 	1.	Testing and Validation:
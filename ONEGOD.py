@@ -429,6 +429,140 @@ All steps verified successfully for both snakes!
 
 Processed Output: 94EEB5EC 5555DC7 0000 0E131617 9521BEDF 55544DC7
 
+⚡ Native Batches with libonegod
+
+ONEGOD.py runs its pipeline one Python int at a time, printing every step, which suits learning and nothing else. For tooling that transforms many words, ONEGOD.cpp builds as a shared library with a C interface (see “C ABI: The Pipeline as a Shared Library” in ONEGOD.cpp):
+
+g++ -std=c++20 -O2 -pthread -shared -fPIC -fvisibility=hidden -DONEGOD_LIBRARY -o libonegod.so ONEGOD.cpp
+
+onegod_native.py wraps it with ctypes. Words travel as numpy uint16 arrays, and a contiguous uint16 array goes to the library by its data pointer, so a batch of any size is one native call with no copy and no per-word Python. The answers are the C++ program’s own: the same compiled pipeline, spec files, seeds and cipher mode, word for word what ./ONEGOD --stream prints.
+
+#!/usr/bin/env python3
+# onegod_native.py
+# Batched Game of Two Snakes transforms through libonegod (ONEGOD.cpp built with -DONEGOD_LIBRARY)
+# Licensed under the MIT License
+
+import ctypes
+import os
+import numpy as np
+
+ABI_VERSION = 1
+SNAKE_A_STREAM = 0xA
+SNAKE_B_STREAM = 0xB
+
+# Arrays are passed as they are: the wrong dtype or layout is an error, never a silent copy
+_words_in = np.ctypeslib.ndpointer(dtype=np.uint16, flags='C_CONTIGUOUS')
+_words_out = np.ctypeslib.ndpointer(dtype=np.uint16, flags='C_CONTIGUOUS,WRITEABLE')
+
+def load_library(path: str = None) -> ctypes.CDLL:
+    # By default libonegod.so beside this file, or wherever ONEGOD_LIBRARY points
+    if path is None:
+        path = os.environ.get('ONEGOD_LIBRARY',
+                              os.path.join(os.path.dirname(os.path.abspath(__file__)), 'libonegod.so'))
+    lib = ctypes.CDLL(path)
+    lib.onegod_abi_version.restype = ctypes.c_int
+    lib.onegod_last_error.restype = ctypes.c_char_p
+    for constructor, argtypes in (('onegod_pipeline_default', []),
+                                  ('onegod_pipeline_from_spec', [ctypes.c_char_p]),
+                                  ('onegod_pipeline_load', [ctypes.c_char_p])):
+        getattr(lib, constructor).restype = ctypes.c_void_p
+        getattr(lib, constructor).argtypes = argtypes
+    lib.onegod_pipeline_free.argtypes = [ctypes.c_void_p]
+    lib.onegod_pipeline_free.restype = None
+    lib.onegod_pipeline_seed.argtypes = [ctypes.c_void_p]
+    lib.onegod_pipeline_seed.restype = ctypes.c_uint64
+    lib.onegod_pipeline_set_seed.argtypes = [ctypes.c_void_p, ctypes.c_uint64]
+    lib.onegod_pipeline_set_cipher.argtypes = [ctypes.c_void_p, ctypes.c_int]
+    for batch in ('onegod_transform_batch', 'onegod_inverse_batch'):
+        getattr(lib, batch).argtypes = [ctypes.c_void_p, _words_in, _words_out, ctypes.c_size_t,
+                                        ctypes.c_uint64, ctypes.c_uint64]
+    if lib.onegod_abi_version() != ABI_VERSION:
+        raise RuntimeError(f"{path}: C ABI version {lib.onegod_abi_version()}, expected {ABI_VERSION}")
+    return lib
+
+class NativePipeline:
+    def __init__(self, spec: str = None, spec_path: str = None, lib: ctypes.CDLL = None):
+        # The default pipeline, or one from spec-file text or a spec file
+        self.handle = None
+        self.lib = lib or load_library()
+        if spec is not None:
+            handle = self.lib.onegod_pipeline_from_spec(spec.encode())
+        elif spec_path is not None:
+            handle = self.lib.onegod_pipeline_load(os.fsencode(spec_path))
+        else:
+            handle = self.lib.onegod_pipeline_default()
+        if not handle:
+            raise ValueError(self.lib.onegod_last_error().decode())
+        self.handle = handle
+
+    def _check(self, status: int) -> None:
+        if status != 0:
+            raise ValueError(self.lib.onegod_last_error().decode())
+
+    @property
+    def seed(self) -> int:
+        return self.lib.onegod_pipeline_seed(self.handle)
+
+    @seed.setter
+    def seed(self, seed: int) -> None:
+        self._check(self.lib.onegod_pipeline_set_seed(self.handle, seed))
+
+    def set_cipher(self, cipher: bool = True) -> None:
+        self._check(self.lib.onegod_pipeline_set_cipher(self.handle, int(cipher)))
+
+    def _batch(self, function, words: np.ndarray, out: np.ndarray, first_index: int, stream: int) -> np.ndarray:
+        if out is None:
+            out = np.empty_like(words)
+        if out.shape != words.shape:
+            raise ValueError(f"out has shape {out.shape}, words {words.shape}")
+        self._check(function(self.handle, words, out, words.size, first_index, stream))
+        return out
+
+    def transform(self, words: np.ndarray, out: np.ndarray = None,
+                  first_index: int = 0, stream: int = SNAKE_B_STREAM) -> np.ndarray:
+        # words[i] is word first_index + i of the stream; out may be words itself
+        return self._batch(self.lib.onegod_transform_batch, words, out, first_index, stream)
+
+    def inverse(self, words: np.ndarray, out: np.ndarray = None,
+                first_index: int = 0, stream: int = SNAKE_B_STREAM) -> np.ndarray:
+        # Cipher mode only: undoes transform with the same first_index and stream
+        return self._batch(self.lib.onegod_inverse_batch, words, out, first_index, stream)
+
+    def close(self) -> None:
+        if self.handle:
+            self.lib.onegod_pipeline_free(self.handle)
+            self.handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self.close()
+
+    def __del__(self):
+        self.close()
+
+if __name__ == "__main__":
+    # Every 16-bit word through Snake B's stream, then a cipher round trip
+    with NativePipeline() as pipeline:
+        words = np.arange(65536, dtype=np.uint16)
+        answers = pipeline.transform(words)
+        print(' '.join(f"{w:04x}" for w in answers[:8]))
+        pipeline.set_cipher()
+        encrypted = pipeline.transform(words)
+        assert np.array_equal(pipeline.inverse(encrypted), words)
+        print("cipher round trip: 65536 words")
+
+Process the Snakes’ hex messages in bulk by parsing them into one array first:
+
+from onegod_native import NativePipeline
+import numpy as np
+
+messages = ['0001', '0083', '0000', '00E5', '73AF']
+with NativePipeline() as pipeline:
+    answers = pipeline.transform(np.array([int(m, 16) for m in messages], dtype=np.uint16))
+print(' '.join(f"{w:04X}" for w in answers))
+
 🌐 Sharing Your Project
 
 To share your project with the world: